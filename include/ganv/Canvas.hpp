@@ -27,6 +27,8 @@
 #include <gtkmm/layout.h>
 #include <sigc++/signal.h>
 
+#include <vector>
+
 /** Ganv namespace, everything is defined under this.
  *
  * @ingroup Ganv
@@ -68,6 +70,8 @@ public:
 	METHODRET0(ganv_canvas, gboolean, empty)
 	METHOD2(ganv_canvas, get_size, double*, width, double*, height)
 	METHOD2(ganv_canvas, resize, double, width, double, height)
+	METHOD0(ganv_canvas, begin_batch)
+	METHOD0(ganv_canvas, end_batch)
 	METHOD4(ganv_canvas, set_scroll_region, double, x1, double, y1, double, x2, double, y2)
 	METHOD4(ganv_canvas, get_scroll_region, double*, x1, double*, y1, double*, x2, double*, y2)
 	METHOD1(ganv_canvas, set_center_scroll_region, gboolean, c)
@@ -90,11 +94,29 @@ public:
 	void  remove_edge_between(Node* tail, Node* head);
 	void  remove_edge(Edge* edge);
 
+	/** Add many modules, ports, and edges at once.
+	 *
+	 * @return The created nodes, with the same indices as @p nodes.
+	 */
+	std::vector<GanvNode*> add_graph(const std::vector<GanvNodeSpec>& nodes,
+	                                 const std::vector<GanvEdgeSpec>& edges) {
+		std::vector<GanvNode*> result(nodes.size(), NULL);
+		ganv_canvas_add_graph(gobj(),
+		                      nodes.data(), nodes.size(),
+		                      edges.data(), edges.size(),
+		                      result.data(), NULL);
+		return result;
+	}
+
 	METHOD0(ganv_canvas, arrange)
 	METHODRET2(ganv_canvas, int, export_image, const char*, filename, bool, draw_background)
 	METHOD1(ganv_canvas, export_dot, const char*, filename)
 	METHODRET0(ganv_canvas, gboolean, supports_sprung_layout)
 	METHODRET1(ganv_canvas, gboolean, set_sprung_layout, gboolean, sprung_layout)
+	METHODRET0(ganv_canvas, gboolean, get_bundle_edges)
+	METHOD1(ganv_canvas, set_bundle_edges, gboolean, bundle_edges)
+	METHODRET0(ganv_canvas, gboolean, get_aggregate_edges)
+	METHOD1(ganv_canvas, set_aggregate_edges, gboolean, aggregate_edges)
 	METHOD2(ganv_canvas, for_each_node, GanvNodeFunc, f, void*, data)
 	METHOD2(ganv_canvas, for_each_selected_node, GanvNodeFunc, f, void*, data)
 	METHOD2(ganv_canvas, for_each_edge, GanvEdgeFunc, f, void*, data)
@@ -118,15 +140,21 @@ public:
 	METHOD1(ganv_canvas, set_zoom, double, pix_per_unit)
 	METHOD0(ganv_canvas, zoom_full)
 	METHODRET0(ganv_canvas, double, get_default_font_size)
+	METHODRET0(ganv_canvas, const char*, get_default_font)
+	METHOD1(ganv_canvas, set_default_font, const char*, font)
 	METHODRET0(ganv_canvas, double, get_font_size)
 	METHOD1(ganv_canvas, set_font_size, double, points)
 	METHOD0(ganv_canvas, get_move_cursor)
 	METHOD2(ganv_canvas, move_contents_to, double, x, double, y)
 
-	RW_PROPERTY(gboolean, locked)
+	bool get_content_bounds(double& x1, double& y1, double& x2, double& y2) const {
+		return ganv_canvas_get_content_bounds(gobj(), &x1, &y1, &x2, &y2);
+	}
+
+	RW_TYPED_PROPERTY(gboolean, locked, ganv_canvas_get_locked)
 	RW_PROPERTY(double, width)
 	RW_PROPERTY(double, height)
-	RW_PROPERTY(GanvDirection, direction)
+	RW_TYPED_PROPERTY(GanvDirection, direction, ganv_canvas_get_direction)
 
 	void set_port_order(GanvPortOrderFunc port_cmp, void* data) {
 		ganv_canvas_set_port_order(gobj(), port_cmp, data);
@@ -149,6 +177,34 @@ private:
 	GanvCanvas* _gobj;
 };
 
+/** A scoped batch of changes to a canvas.
+ *
+ * Updates, redraws, and layout restarts are deferred while this exists, and
+ * applied once when it is destroyed.
+ *
+ * @ingroup Ganv
+ */
+class CanvasBatch
+{
+public:
+	explicit CanvasBatch(Canvas& canvas)
+		: _canvas(canvas)
+	{
+		_canvas.begin_batch();
+	}
+
+	CanvasBatch(const CanvasBatch&) = delete;
+	CanvasBatch& operator=(const CanvasBatch&) = delete;
+
+	CanvasBatch(CanvasBatch&&)  = delete;
+	CanvasBatch& operator=(CanvasBatch&&) = delete;
+
+	~CanvasBatch() { _canvas.end_batch(); }
+
+private:
+	Canvas& _canvas;
+};
+
 } // namespace Ganv
 
 namespace Glib {
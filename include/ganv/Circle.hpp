@@ -65,9 +65,9 @@ public:
 				       nullptr)))
 	{}
 
-	RW_PROPERTY(double, radius)
-	RW_PROPERTY(double, radius_ems)
-	RW_PROPERTY(gboolean, fit_label)
+	RW_TYPED_PROPERTY(double, radius, ganv_circle_get_radius)
+	RW_TYPED_PROPERTY(double, radius_ems, ganv_circle_get_radius_ems)
+	RW_TYPED_PROPERTY(gboolean, fit_label, ganv_circle_get_fit_label)
 
 	GanvCircle*       gobj()       { return GANV_CIRCLE(_gobj); }
 	const GanvCircle* gobj() const { return GANV_CIRCLE(_gobj); }
@@ -75,10 +75,10 @@ public:
 		return ganv_edge_is_within(gobj(), x1, y1, x2, y2);
 	}
 
-	RW_PROPERTY(gboolean, constraining)
-	RW_PROPERTY(gboolean, curved)
-	RW_PROPERTY(gboolean, selected)
-	RW_PROPERTY(gboolean, highlighted)
+	RW_TYPED_PROPERTY(gboolean, constraining, ganv_edge_get_constraining)
+	RW_TYPED_PROPERTY(gboolean, curved, ganv_edge_get_curved)
+	RW_TYPED_PROPERTY(gboolean, selected, ganv_edge_get_selected)
+	RW_TYPED_PROPERTY(gboolean, highlighted, ganv_edge_get_highlighted)
 	RW_PROPERTY(guint,    color)
 	RW_PROPERTY(gdouble,  handle_radius)
 
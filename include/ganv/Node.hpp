@@ -55,8 +55,8 @@ public:
 		g_object_unref(_gobj);
 	}
 
-	RW_PROPERTY(gboolean, can_tail)
-	RW_PROPERTY(gboolean, can_head)
+	RW_TYPED_PROPERTY(gboolean, can_tail, ganv_node_can_tail)
+	RW_TYPED_PROPERTY(gboolean, can_head, ganv_node_can_head)
 	RW_PROPERTY(gboolean, is_source)
 
 	gboolean is_within(double x1, double y1, double x2, double y2) const {
@@ -69,7 +69,7 @@ public:
 	RW_PROPERTY(double, dash_offset)
 	RW_PROPERTY(guint, fill_color)
 	RW_PROPERTY(guint, border_color)
-	RW_PROPERTY(gboolean, selected)
+	RW_TYPED_PROPERTY(gboolean, selected, ganv_node_is_selected)
 	RW_PROPERTY(gboolean, highlighted)
 	RW_PROPERTY(gboolean, draggable)
 	RW_PROPERTY(gboolean, grabbed)
@@ -102,6 +102,36 @@ typedef void (*GanvNodeFunc)(GanvNode* node, void* data);
  */
 typedef int (*GanvPortOrderFunc)(const GanvPort* lhs, const GanvPort* rhs, void* data);
 
+/**
+ * GanvNodeSpec:
+ * @label: Label text, or NULL.
+ * @x: X coordinate of a module, ignored for ports.
+ * @y: Y coordinate of a module, ignored for ports.
+ * @module: Index of the module spec this port belongs to, or -1 for a module.
+ * @is_input: True if this port is an input, ignored for modules.
+ *
+ * Description of a module or port for ganv_canvas_add_graph().
+ */
+typedef struct {
+	const char* label;
+	double      x;
+	double      y;
+	int         module;
+	gboolean    is_input;
+} GanvNodeSpec;
+
+/**
+ * GanvEdgeSpec:
+ * @tail: Index of the tail node spec.
+ * @head: Index of the head node spec.
+ *
+ * Description of an edge for ganv_canvas_add_graph().
+ */
+typedef struct {
+	guint tail;
+	guint head;
+} GanvEdgeSpec;
+
 /**
  * ganv_canvas_new:
  *
@@ -158,6 +188,28 @@ ganv_canvas_get_size(GanvCanvas* canvas, double* width, double* height);
 void
 ganv_canvas_resize(GanvCanvas* canvas, double width, double height);
 
+/**
+ * ganv_canvas_begin_batch:
+ *
+ * Begin a batch of changes, such as loading a large graph.
+ *
+ * Until the matching ganv_canvas_end_batch(), item updates, redraws, resizes,
+ * and layout restarts are deferred so that they happen only once for the whole
+ * batch.  Batches may be nested.
+ */
+void
+ganv_canvas_begin_batch(GanvCanvas* canvas);
+
+/**
+ * ganv_canvas_end_batch:
+ *
+ * End a batch of changes started with ganv_canvas_begin_batch().
+ *
+ * When the outermost batch ends, all deferred work is applied at once.
+ */
+void
+ganv_canvas_end_batch(GanvCanvas* canvas);
+
 /**
  * ganv_canvas_root:
  * @canvas: A canvas.
@@ -388,13 +440,36 @@ ganv_canvas_remove_edge_between(GanvCanvas* canvas,
                                 GanvNode*   tail,
                                 GanvNode*   head);
 
+/**
+ * ganv_canvas_add_graph:
+ * @nodes: Array of @n_nodes module and port descriptions.
+ * @edges: Array of @n_edges edge descriptions.
+ * @nodes_out: Array of @n_nodes to store created nodes in, or NULL.
+ * @edges_out: Array of @n_edges to store created edges in, or NULL.
+ *
+ * Add many modules, ports, and edges at once.
+ *
+ * Ports must come after the module they belong to, and edges refer to nodes
+ * by their index in @nodes.  Everything is added in a single batch, so the
+ * canvas is only updated and redrawn once.  Invalid specs are skipped with a
+ * warning, and the corresponding output is set to NULL.
+ */
+void
+ganv_canvas_add_graph(GanvCanvas*         canvas,
+                      const GanvNodeSpec* nodes,
+                      guint               n_nodes,
+                      const GanvEdgeSpec* edges,
+                      guint               n_edges,
+                      GanvNode**          nodes_out,
+                      GanvEdge**          edges_out);
+
 /**
  * ganv_canvas_get_direction:
  *
  * Return the direction of signal flow.
  */
 GanvDirection
-ganv_canvas_get_direction(GanvCanvas* canvas);
+ganv_canvas_get_direction(const GanvCanvas* canvas);
 
 /**
  * ganv_canvas_set_direction:
@@ -459,6 +534,45 @@ ganv_canvas_set_sprung_layout(GanvCanvas* canvas, gboolean sprung_layout);
 gboolean
 ganv_canvas_get_locked(const GanvCanvas* canvas);
 
+/**
+ * ganv_canvas_get_bundle_edges:
+ *
+ * Return true iff curved edges between the same modules are bundled.
+ */
+gboolean
+ganv_canvas_get_bundle_edges(const GanvCanvas* canvas);
+
+/**
+ * ganv_canvas_set_bundle_edges:
+ *
+ * Enable or disable edge bundling.  When enabled, curved edges between ports
+ * on the same two modules are routed through shared points, so dense
+ * connections are drawn as a single bundle rather than a tangle.  Edges in a
+ * bundle that look the same are stroked together as one path, and hovered or
+ * selected edges are drawn over it.
+ */
+void
+ganv_canvas_set_bundle_edges(GanvCanvas* canvas, gboolean bundle_edges);
+
+/**
+ * ganv_canvas_get_aggregate_edges:
+ *
+ * Return true iff edges between the same modules are aggregated into cables.
+ */
+gboolean
+ganv_canvas_get_aggregate_edges(const GanvCanvas* canvas);
+
+/**
+ * ganv_canvas_set_aggregate_edges:
+ *
+ * Enable or disable edge aggregation.  When enabled, all edges between ports
+ * on the same two modules are drawn as a single cable labeled with the number
+ * of edges.  A cable is expanded into its edges while any of them is
+ * highlighted or selected, or when zoomed in closely.
+ */
+void
+ganv_canvas_set_aggregate_edges(GanvCanvas* canvas, gboolean aggregate_edges);
+
 /**
  * ganv_canvas_for_each_node:
  * @canvas: The canvas.
@@ -595,6 +709,26 @@ ganv_canvas_zoom_full(GanvCanvas* canvas);
 double
 ganv_canvas_get_default_font_size(const GanvCanvas* canvas);
 
+/**
+ * ganv_canvas_get_default_font:
+ *
+ * Return the font set with ganv_canvas_set_default_font(), or NULL.
+ */
+const char*
+ganv_canvas_get_default_font(const GanvCanvas* canvas);
+
+/**
+ * ganv_canvas_set_default_font:
+ * @font: Pango font description string, like "Sans 9", or NULL.
+ *
+ * Set the font that all text is based on.  By default, the font of the widget
+ * style is used, but setting a font here allows text to be measured, and the
+ * canvas laid out, without a display.  If the font has a size, it also becomes
+ * the current font size, as if set with ganv_canvas_set_font_size().
+ */
+void
+ganv_canvas_set_default_font(GanvCanvas* canvas, const char* font);
+
 /**
  * ganv_canvas_get_font_size:
  *
@@ -627,6 +761,19 @@ ganv_canvas_get_move_cursor(const GanvCanvas* canvas);
 void
 ganv_canvas_move_contents_to(GanvCanvas* canvas, double x, double y);
 
+/**
+ * ganv_canvas_get_content_bounds:
+ *
+ * Get the bounding box of all top level nodes in world coordinates.
+ *
+ * Return value: False if there are no nodes, in which case the output
+ * parameters are not set.
+ */
+gboolean
+ganv_canvas_get_content_bounds(const GanvCanvas* canvas,
+                               double* x1, double* y1,
+                               double* x2, double* y2);
+
 /**
  * ganv_canvas_set_port_order:
  * @canvas: The canvas to set the default port order on.
@@ -76,9 +76,15 @@ ganv_edge_get_constraining(const GanvEdge* edge);
 void
 ganv_edge_set_constraining(GanvEdge* edge, gboolean constraining);
 
+gboolean
+ganv_edge_get_selected(const GanvEdge* edge);
+
 void
 ganv_edge_set_selected(GanvEdge* edge, gboolean selected);
 
+gboolean
+ganv_edge_get_highlighted(const GanvEdge* edge);
+
 void
 ganv_edge_set_highlighted(GanvEdge* edge, gboolean highlighted);
 
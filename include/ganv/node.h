@@ -177,7 +177,7 @@ void
 ganv_node_disconnect(GanvNode* node);
 
 gboolean
-ganv_node_is_selected(GanvNode* node);
+ganv_node_is_selected(const GanvNode* node);
 
 G_END_DECLS
 
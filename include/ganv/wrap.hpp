@@ -48,6 +48,18 @@ private: \
 	SIGNAL1(name, type) \
 	public:
 
+/* Like RW_PROPERTY, but read with a typed C getter rather than by name.
+   Setting still goes through the property so notify signals are emitted. */
+#define RW_TYPED_PROPERTY(type, name, getter) \
+	virtual type get_##name() const { \
+		return getter(gobj()); \
+	} \
+	virtual void set_##name(type value) { \
+		g_object_set(G_OBJECT(_gobj), #name, value, nullptr); \
+	} \
+	SIGNAL1(name, type) \
+	public:
+
 #define RW_OBJECT_PROPERTY(type, name) \
 	type get_##name() const { \
 		if (!_gobj) return nullptr; \
@@ -39,6 +39,7 @@
 #include <ganv/module.h>
 #include <ganv/node.h>
 #include <ganv/port.h>
+#include <ganv/text.h>
 #include <ganv/types.h>
 
 #include <cairo-pdf.h>
@@ -60,13 +61,16 @@
 #include <gtkmm/style.h>
 #include <gtkmm/widget.h>
 #include <pango/pango-font.h>
+#include <pango/pango-layout.h>
 #include <pango/pango-types.h>
+#include <pango/pangocairo.h>
 #include <pangomm/fontdescription.h>
 #include <sigc++/signal.h>
 
 #include <algorithm>
 #include <cassert>
 #include <cfloat>
+#include <climits>
 #include <clocale>
 #include <cmath>
 #include <cstdint>
@@ -74,10 +78,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <list>
 #include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -100,6 +106,9 @@
 
 static const double GANV_CANVAS_PAD = 8.0;
 
+/* Font used when no default is set and there is no display to get one from */
+static const char* const GANV_FALLBACK_FONT = "Sans 10";
+
 struct GanvCanvasImpl;
 
 struct IRect {
@@ -109,13 +118,25 @@ struct IRect {
 	int height;
 };
 
+struct DRect {
+	double x1;
+	double y1;
+	double x2;
+	double y2;
+};
+
 extern "C" {
 static void add_idle(GanvCanvas* canvas);
+static void remove_idle(GanvCanvas* canvas);
+static void update_items(GanvCanvas* canvas);
+static void expand_to_content(GanvCanvas* canvas);
 static void ganv_canvas_destroy(GtkObject* object);
 static void ganv_canvas_map(GtkWidget* widget);
 static void ganv_canvas_unmap(GtkWidget* widget);
 static void ganv_canvas_realize(GtkWidget* widget);
 static void ganv_canvas_unrealize(GtkWidget* widget);
+static void ganv_canvas_screen_changed(GtkWidget* widget,
+                                       GdkScreen* previous_screen);
 static void ganv_canvas_size_allocate(GtkWidget*     widget,
                                       GtkAllocation* allocation);
 static gint ganv_canvas_button(GtkWidget*      widget,
@@ -143,24 +164,137 @@ static guint signal_disconnect;
 
 static GEnumValue dir_values[3];
 
-using Items = std::set<GanvNode*>;
+/* Set of nodes or edges that iterates in insertion order.
+
+   Each item stores its position in the set in the given field of its private
+   struct, so membership tests and removal are O(1).  Removal leaves a hole
+   rather than shifting later items, so items may be removed while iterating.
+   Holes are compacted away on insertion when they outnumber the items.
+*/
+template<typename T, typename Private>
+class ItemList
+{
+public:
+	using Index = guint Private::*;
+
+	explicit ItemList(Index index) : _index(index), _size(0) {}
+
+	class const_iterator
+	{
+	public:
+		const_iterator(const ItemList* list, size_t i) : _list(list), _i(i)
+		{
+			skip_holes();
+		}
+
+		T* operator*() const { return _list->_items[_i]; }
+
+		const_iterator& operator++()
+		{
+			++_i;
+			skip_holes();
+			return *this;
+		}
+
+		bool operator==(const const_iterator& rhs) const
+		{
+			return (at_end() && rhs.at_end()) || _i == rhs._i;
+		}
+
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+	private:
+		bool at_end() const { return _i >= _list->_items.size(); }
+
+		void skip_holes()
+		{
+			while (!at_end() && !_list->_items[_i]) {
+				++_i;
+			}
+		}
+
+		const ItemList* _list;
+		size_t          _i;
+	};
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, _items.size()); }
+
+	bool   empty() const { return _size == 0; }
+	size_t size() const { return _size; }
+
+	bool contains(const T* item) const
+	{
+		const guint i = item->impl->*_index;
+		return i < _items.size() && _items[i] == item;
+	}
+
+	bool insert(T* item)
+	{
+		if (contains(item)) {
+			return false;
+		}
+
+		if (_items.size() >= 2 * _size + 16) {
+			compact();
+		}
+
+		item->impl->*_index = (guint)_items.size();
+		_items.push_back(item);
+		++_size;
+		return true;
+	}
+
+	bool erase(T* item)
+	{
+		if (!contains(item)) {
+			return false;
+		}
+
+		_items[item->impl->*_index] = NULL;
+		if (--_size == 0) {
+			_items.clear();
+		}
+		return true;
+	}
+
+	void clear()
+	{
+		_items.clear();
+		_size = 0;
+	}
+
+private:
+	void compact()
+	{
+		size_t n = 0;
+		for (T* item : _items) {
+			if (item) {
+				item->impl->*_index = (guint)n;
+				_items[n++]         = item;
+			}
+		}
+		_items.resize(n);
+	}
+
+	Index           _index; ///< Field in items that holds their index
+	std::vector<T*> _items; ///< Items in insertion order, or NULL
+	size_t          _size;  ///< Number of items, excluding holes
+};
+
+using Items = ItemList<GanvNode, _GanvNodePrivate>;
 
 #define FOREACH_ITEM(items, i) \
 	for (Items::const_iterator i = items.begin(); i != items.end(); ++i)
 
-#define FOREACH_ITEM_MUT(items, i) \
-	for (Items::iterator i = items.begin(); i != items.end(); ++i)
-
 #define FOREACH_EDGE(edges, i) \
 	for (GanvCanvasImpl::Edges::const_iterator i = edges.begin(); \
 	     i != edges.end(); \
 	     ++i)
 
-#define FOREACH_EDGE_MUT(edges, i) \
-	for (GanvCanvasImpl::Edges::iterator i = edges.begin(); \
-	     i != edges.end(); \
-	     ++i)
-
 #define FOREACH_SELECTED_EDGE(edges, i) \
 	for (GanvCanvasImpl::SelectedEdges::const_iterator i = edges.begin(); \
 	     i != edges.end(); \
@@ -190,22 +324,560 @@ public:
 static const uint32_t SELECT_RECT_FILL_COLOUR   = 0x2E444577;
 static const uint32_t SELECT_RECT_BORDER_COLOUR = 0x2E4445FF;
 
-/* Order edges by (tail, head) */
-struct TailHeadOrder {
-	inline bool operator()(const GanvEdge* a, const GanvEdge* b) const {
-		return ((a->impl->tail < b->impl->tail)
-		        || (a->impl->tail == b->impl->tail
-		            && a->impl->head < b->impl->head));
+/* Key for looking up an edge by its (tail, head) nodes */
+using EdgeKey = std::pair<const GanvNode*, const GanvNode*>;
+
+struct EdgeKeyHash {
+	inline size_t operator()(const EdgeKey& key) const {
+		const size_t h = std::hash<const GanvNode*>()(key.first);
+		return h ^ (std::hash<const GanvNode*>()(key.second) + 0x9E3779B9
+		            + (h << 6) + (h >> 2));
+	}
+};
+
+/* Edges connected to a node, in the order they were added */
+struct NodeEdges {
+	std::vector<GanvEdge*> out; ///< Edges with this node as tail
+	std::vector<GanvEdge*> in;  ///< Edges with this node as head
+};
+
+/* Edges between the same two modules, drawn as one cable when aggregated */
+struct Cable {
+	Cable() : n_active(0), hovered(false) {}
+
+	std::vector<GanvEdge*> edges;    ///< Edges in the order they were added
+	unsigned               n_active; ///< Number of selected or highlighted edges
+	bool                   hovered;  ///< True while the pointer is over it
+};
+
+/* Zoom level at which aggregated cables are expanded into their edges */
+static const double CABLE_EXPAND_ZOOM = 1.5;
+
+/* Uniform grid of top level items, for quickly finding items in an area */
+class SpatialIndex
+{
+public:
+	/* Insert or move an item with the given world bounds */
+	void update(GanvItem* item, const DRect& rect)
+	{
+		const Cells cells = get_cells(rect);
+		const ItemCells::iterator i = _items.find(item);
+		if (i != _items.end()) {
+			if (i->second.x1 == cells.x1 && i->second.y1 == cells.y1
+			    && i->second.x2 == cells.x2 && i->second.y2 == cells.y2) {
+				return;  // Still in the same cells
+			}
+			remove_cells(item, i->second);
+			i->second = cells;
+		} else {
+			_items.insert(std::make_pair(item, cells));
+		}
+
+		if (is_oversized(cells)) {
+			_oversized.push_back(item);
+			return;
+		}
+
+		for (int y = cells.y1; y <= cells.y2; ++y) {
+			for (int x = cells.x1; x <= cells.x2; ++x) {
+				_cells[std::make_pair(x, y)].push_back(item);
+			}
+		}
+	}
+
+	void remove(GanvItem* item)
+	{
+		const ItemCells::iterator i = _items.find(item);
+		if (i != _items.end()) {
+			remove_cells(item, i->second);
+			_items.erase(i);
+		}
+	}
+
+	void clear()
+	{
+		_cells.clear();
+		_items.clear();
+		_oversized.clear();
+	}
+
+	/* Call f once for every item that may overlap the given world rect */
+	template<typename F>
+	void query(const DRect& rect, F f) const
+	{
+		const Cells q = get_cells(rect);
+		for (int y = q.y1; y <= q.y2; ++y) {
+			for (int x = q.x1; x <= q.x2; ++x) {
+				const CellMap::const_iterator c = _cells.find(std::make_pair(x, y));
+				if (c == _cells.end()) {
+					continue;
+				}
+
+				for (GanvItem* item : c->second) {
+					// Report items spanning several cells only from the first
+					const Cells& ic = _items.find(item)->second;
+					if (x == std::max(ic.x1, q.x1) && y == std::max(ic.y1, q.y1)) {
+						f(item);
+					}
+				}
+			}
+		}
+
+		for (GanvItem* item : _oversized) {
+			f(item);
+		}
+	}
+
+private:
+	struct Cells {
+		int x1;
+		int y1;
+		int x2;
+		int y2;
+	};
+
+	using Cell      = std::pair<int, int>;
+	using CellMap   = std::map<Cell, std::vector<GanvItem*>>;
+	using ItemCells = std::map<GanvItem*, Cells>;
+
+	static constexpr double CELL_SIZE = 128.0;
+	static constexpr int    MAX_CELLS = 64;
+
+	static int get_cell(double coord)
+	{
+		const double c = floor(coord / CELL_SIZE);
+		return (int)std::max((double)INT_MIN / 2, std::min((double)INT_MAX / 2, c));
+	}
+
+	static Cells get_cells(const DRect& r)
+	{
+		const Cells cells = { get_cell(r.x1), get_cell(r.y1),
+		                      get_cell(r.x2), get_cell(r.y2) };
+		return cells;
 	}
+
+	static bool is_oversized(const Cells& c)
+	{
+		return (c.x2 - c.x1 >= MAX_CELLS) || (c.y2 - c.y1 >= MAX_CELLS);
+	}
+
+	static void erase_item(std::vector<GanvItem*>& items, GanvItem* item)
+	{
+		items.erase(std::remove(items.begin(), items.end(), item), items.end());
+	}
+
+	void remove_cells(GanvItem* item, const Cells& cells)
+	{
+		if (is_oversized(cells)) {
+			erase_item(_oversized, item);
+			return;
+		}
+
+		for (int y = cells.y1; y <= cells.y2; ++y) {
+			for (int x = cells.x1; x <= cells.x2; ++x) {
+				const CellMap::iterator c = _cells.find(std::make_pair(x, y));
+				if (c != _cells.end()) {
+					erase_item(c->second, item);
+					if (c->second.empty()) {
+						_cells.erase(c);
+					}
+				}
+			}
+		}
+	}
+
+	CellMap                _cells;     ///< Items overlapping each cell
+	ItemCells              _items;     ///< Cells covered by each item
+	std::vector<GanvItem*> _oversized; ///< Items too large to put in cells
 };
 
-/* Order edges by (head, tail) */
-struct HeadTailOrder {
-	inline bool operator()(const GanvEdge* a, const GanvEdge* b) const {
-		return ((a->impl->head < b->impl->head)
-		        || (a->impl->head == b->impl->head
-		            && a->impl->tail < b->impl->tail));
+/* Bounds of all top level nodes, maintained as items move */
+class ContentBounds
+{
+public:
+	/* Insert or move an item with the given world bounds */
+	void update(GanvItem* item, const DRect& rect)
+	{
+		const Rects::iterator i = _rects.find(item);
+		if (i != _rects.end()) {
+			const DRect& old = i->second;
+			if (old.x1 == rect.x1 && old.y1 == rect.y1
+			    && old.x2 == rect.x2 && old.y2 == rect.y2) {
+				return;
+			}
+			erase_rect(old);
+			i->second = rect;
+		} else {
+			_rects.insert(std::make_pair(item, rect));
+		}
+
+		_x1s.insert(rect.x1);
+		_y1s.insert(rect.y1);
+		_x2s.insert(rect.x2);
+		_y2s.insert(rect.y2);
+	}
+
+	void remove(GanvItem* item)
+	{
+		const Rects::iterator i = _rects.find(item);
+		if (i != _rects.end()) {
+			erase_rect(i->second);
+			_rects.erase(i);
+		}
+	}
+
+	void clear()
+	{
+		_rects.clear();
+		_x1s.clear();
+		_y1s.clear();
+		_x2s.clear();
+		_y2s.clear();
+	}
+
+	/* Get the bounds of all items, or return false if there are none */
+	bool get(DRect* rect) const
+	{
+		if (_rects.empty()) {
+			return false;
+		}
+
+		rect->x1 = *_x1s.begin();
+		rect->y1 = *_y1s.begin();
+		rect->x2 = *_x2s.rbegin();
+		rect->y2 = *_y2s.rbegin();
+		return true;
+	}
+
+private:
+	using Rects  = std::map<GanvItem*, DRect>;
+	using Coords = std::multiset<double>;
+
+	void erase_rect(const DRect& rect)
+	{
+		_x1s.erase(_x1s.find(rect.x1));
+		_y1s.erase(_y1s.find(rect.y1));
+		_x2s.erase(_x2s.find(rect.x2));
+		_y2s.erase(_y2s.find(rect.y2));
+	}
+
+	Rects  _rects; ///< World bounds of each item
+	Coords _x1s;   ///< Left edges of all items
+	Coords _y1s;   ///< Top edges of all items
+	Coords _x2s;   ///< Right edges of all items
+	Coords _y2s;   ///< Bottom edges of all items
+};
+
+/* Pango layouts shared by all labels with the same text and font.
+
+   Layouts are reference counted, every get() must be balanced by a call to
+   release().  Layouts that are no longer used are kept around for reuse, up
+   to a limit, and the least recently used of those are freed first.
+
+   Layouts are created in a context from a font map owned by the cache, not
+   by the widget, so text can be measured without a display.
+
+   Each layout also has an alpha mask of its rendered glyphs at the last scale
+   it was drawn at, so drawing is a mask blit rather than rasterising text on
+   every expose.  Masks are limited to a total size, and the least recently
+   drawn are freed first.
+*/
+class LayoutCache
+{
+public:
+	LayoutCache()
+		: _mask_bytes(0)
+		, _font_map(pango_cairo_font_map_new())
+		, _context(pango_font_map_create_context(_font_map))
+	{}
+
+	LayoutCache(const LayoutCache&) = delete;
+	LayoutCache& operator=(const LayoutCache&) = delete;
+
+	~LayoutCache()
+	{
+		clear();
+		g_object_unref(_context);
+		g_object_unref(_font_map);
+	}
+
+	/* Match the resolution and font options of a screen, if there is one.
+	   Otherwise, the Pango defaults are used.  Existing layouts are updated,
+	   so this can be called again when the widget moves to another screen. */
+	void match_screen(GdkScreen* screen)
+	{
+		if (screen) {
+			const double dpi = gdk_screen_get_resolution(screen);
+			if (dpi > 0.0) {
+				pango_cairo_context_set_resolution(_context, dpi);
+			}
+
+			const cairo_font_options_t* opt = gdk_screen_get_font_options(screen);
+			if (opt) {
+				pango_cairo_context_set_font_options(_context, opt);
+			}
+
+			clear_masks();
+			for (auto& i : _entries) {
+				Entry& entry = i.second;
+				pango_layout_context_changed(entry.layout);
+				pango_layout_get_pixel_size(
+					entry.layout, &entry.width, &entry.height);
+			}
+		}
+	}
+
+	/* Get a new reference to a layout and its size in pixels */
+	PangoLayout* get(const PangoFontDescription* base_font,
+	                 const char*                 text,
+	                 double                      points,
+	                 int*                        width,
+	                 int*                        height)
+	{
+		char* font = pango_font_description_to_string(base_font);
+		const Key key{text ? text : "", font, points};
+		g_free(font);
+
+		Entries::iterator i = _entries.find(key);
+		if (i == _entries.end()) {
+			Entry entry;
+			entry.layout = create(base_font, text, points);
+			entry.refs   = 0;
+			entry.mask   = NULL;
+			pango_layout_get_pixel_size(entry.layout, &entry.width, &entry.height);
+
+			i = _entries.insert(std::make_pair(key, entry)).first;
+			_by_layout.insert(std::make_pair(entry.layout, &*i));
+		} else if (i->second.refs == 0) {
+			_unused.erase(i->second.unused);
+		}
+
+		Entry& entry = i->second;
+		++entry.refs;
+		*width  = entry.width;
+		*height = entry.height;
+		return PANGO_LAYOUT(g_object_ref(entry.layout));
+	}
+
+	/* Release a reference to a layout returned by get() */
+	void release(PangoLayout* layout)
+	{
+		const ByLayout::iterator l = _by_layout.find(layout);
+		if (l != _by_layout.end() && --l->second->second.refs == 0) {
+			Value* const value = l->second;
+			_unused.push_front(value);
+			value->second.unused = _unused.begin();
+			while (_unused.size() > MAX_UNUSED) {
+				evict(_unused.back());
+				_unused.pop_back();
+			}
+		}
+
+		g_object_unref(layout);
+	}
+
+	/* Draw a layout returned by get() with its top left at x, y */
+	void draw(cairo_t* cr, PangoLayout* layout, double x, double y)
+	{
+		// Only use masks for unrotated, uniformly scaled, drawing
+		cairo_matrix_t m;
+		cairo_get_matrix(cr, &m);
+
+		const ByLayout::iterator l = _by_layout.find(layout);
+		if (l == _by_layout.end() || m.xy != 0.0 || m.yx != 0.0 ||
+		    m.xx != m.yy || m.xx <= 0.0) {
+			cairo_move_to(cr, x, y);
+			pango_cairo_show_layout(cr, layout);
+			return;
+		}
+
+		Value* const value = l->second;
+		Entry&       entry = value->second;
+		if (!entry.mask || entry.mask_scale != m.xx) {
+			drop_mask(value);
+			render_mask(value, m.xx);
+		} else {
+			_masked.splice(_masked.begin(), _masked, entry.masked);
+		}
+
+		if (!entry.mask) {
+			// Too large to cache
+			cairo_move_to(cr, x, y);
+			pango_cairo_show_layout(cr, layout);
+			return;
+		}
+
+		// Snap to whole device pixels so the mask is used without filtering
+		double dx = x;
+		double dy = y;
+		cairo_user_to_device(cr, &dx, &dy);
+
+		cairo_save(cr);
+		cairo_identity_matrix(cr);
+		cairo_mask_surface(cr, entry.mask,
+		                   round(dx) + entry.mask_x,
+		                   round(dy) + entry.mask_y);
+		cairo_restore(cr);
 	}
+
+	/* Free all masks, for when the zoom or font changes */
+	void clear_masks()
+	{
+		while (!_masked.empty()) {
+			drop_mask(_masked.back());
+		}
+	}
+
+	void clear()
+	{
+		clear_masks();
+		for (auto& i : _entries) {
+			g_object_unref(i.second.layout);
+		}
+		_entries.clear();
+		_by_layout.clear();
+		_unused.clear();
+	}
+
+private:
+	struct Key {
+		std::string text;   ///< Label text
+		std::string font;   ///< Style font description
+		double      points; ///< Font size in points
+
+		bool operator==(const Key& rhs) const
+		{
+			return points == rhs.points && text == rhs.text && font == rhs.font;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const
+		{
+			const size_t h = std::hash<std::string>()(key.text);
+			return h ^ (std::hash<std::string>()(key.font) + 0x9E3779B9
+			            + std::hash<double>()(key.points)
+			            + (h << 6) + (h >> 2));
+		}
+	};
+
+	struct Entry;
+
+	using Value  = std::pair<const Key, Entry>;
+	using Unused = std::list<Value*>;
+	using Masked = std::list<Value*>;
+
+	struct Entry {
+		PangoLayout*     layout;     ///< Shared layout
+		int              width;      ///< Width in pixels
+		int              height;     ///< Height in pixels
+		unsigned         refs;       ///< Number of users
+		Unused::iterator unused;     ///< Position in _unused if refs is zero
+		cairo_surface_t* mask;       ///< Rendered glyphs, or NULL
+		double           mask_scale; ///< Device pixels per unit of mask
+		int              mask_x;     ///< Mask left relative to layout origin
+		int              mask_y;     ///< Mask top relative to layout origin
+		size_t           mask_bytes; ///< Size of mask data
+		Masked::iterator masked;     ///< Position in _masked if mask is set
+	};
+
+	using Entries  = std::unordered_map<Key, Entry, KeyHash>;
+	using ByLayout = std::unordered_map<const PangoLayout*, Value*>;
+
+	/* Maximum number of unused layouts to keep */
+	static const size_t MAX_UNUSED = 256;
+
+	/* Maximum total size of masks in bytes */
+	static const size_t MAX_MASK_BYTES = 16 * 1024 * 1024;
+
+	PangoLayout* create(const PangoFontDescription* base_font,
+	                    const char*                 text,
+	                    double                      points)
+	{
+		PangoLayout*          layout = pango_layout_new(_context);
+		PangoFontDescription* font   = pango_font_description_copy(base_font);
+
+		pango_font_description_set_size(font, points * (double)PANGO_SCALE);
+		pango_layout_set_font_description(layout, font);
+		pango_layout_set_text(layout, text ? text : "", -1);
+		pango_font_description_free(font);
+
+		return layout;
+	}
+
+	void render_mask(Value* value, double scale)
+	{
+		Entry& entry = value->second;
+
+		// Ink extents in device pixels, with a pixel of room for antialiasing
+		PangoRectangle ink;
+		pango_layout_get_extents(entry.layout, &ink, NULL);
+
+		const double s  = scale / PANGO_SCALE;
+		const int    x1 = (int)floor(ink.x * s) - 1;
+		const int    y1 = (int)floor(ink.y * s) - 1;
+		const int    x2 = (int)ceil((ink.x + ink.width) * s) + 1;
+		const int    y2 = (int)ceil((ink.y + ink.height) * s) + 1;
+
+		const int    stride = cairo_format_stride_for_width(CAIRO_FORMAT_A8,
+		                                                    x2 - x1);
+		const size_t bytes  = (size_t)stride * (size_t)(y2 - y1);
+		if (stride <= 0 || bytes > MAX_MASK_BYTES / 16) {
+			return;
+		}
+
+		cairo_surface_t* mask = cairo_image_surface_create(
+			CAIRO_FORMAT_A8, x2 - x1, y2 - y1);
+
+		cairo_t* cr = cairo_create(mask);
+		cairo_translate(cr, -x1, -y1);
+		cairo_scale(cr, scale, scale);
+		pango_cairo_show_layout(cr, entry.layout);
+		cairo_destroy(cr);
+
+		entry.mask       = mask;
+		entry.mask_scale = scale;
+		entry.mask_x     = x1;
+		entry.mask_y     = y1;
+		entry.mask_bytes = bytes;
+
+		_masked.push_front(value);
+		entry.masked = _masked.begin();
+		_mask_bytes += bytes;
+		while (_mask_bytes > MAX_MASK_BYTES) {
+			drop_mask(_masked.back());
+		}
+	}
+
+	void drop_mask(Value* value)
+	{
+		Entry& entry = value->second;
+		if (entry.mask) {
+			cairo_surface_destroy(entry.mask);
+			_masked.erase(entry.masked);
+			_mask_bytes -= entry.mask_bytes;
+			entry.mask = NULL;
+		}
+	}
+
+	void evict(Value* value)
+	{
+		drop_mask(value);
+
+		PangoLayout* const layout = value->second.layout;
+		_by_layout.erase(layout);
+		_entries.erase(_entries.find(value->first));
+		g_object_unref(layout);
+	}
+
+	Entries  _entries;   ///< Layouts by text and font
+	ByLayout _by_layout; ///< Entries by layout, for releasing
+	Unused   _unused;    ///< Unused entries, most recently used first
+	Masked   _masked;    ///< Entries with masks, most recently drawn first
+	size_t   _mask_bytes; ///< Total size of all masks
+
+	PangoFontMap* _font_map; ///< Font map for measuring and drawing text
+	PangoContext* _context;  ///< Context for all layouts
 };
 
 /* Callback used when the root item of a canvas is destroyed.  The user should
@@ -221,6 +893,10 @@ struct GanvCanvasImpl {
 	explicit GanvCanvasImpl(GanvCanvas* canvas)
 		: _gcanvas(canvas)
 		, _wrapper(NULL)
+		, _items(&_GanvNodePrivate::canvas_index)
+		, _selected_items(&_GanvNodePrivate::selected_index)
+		, _selected_edges(&_GanvEdgePrivate::selected_index)
+		, _stale_text(&_GanvNodePrivate::stale_index)
 		, _connect_port(NULL)
 		, _last_selected_port(NULL)
 		, _drag_edge(NULL)
@@ -254,8 +930,15 @@ struct GanvCanvasImpl {
 		this->scroll_x2 = canvas->layout.width;
 		this->scroll_y2 = canvas->layout.height;
 
+		this->default_font      = NULL;
+		this->default_font_desc = gdk_screen_get_default()
+			? NULL
+			: pango_font_description_from_string(GANV_FALLBACK_FONT);
+
 		this->pixels_per_unit = 1.0;
-		this->font_size       = ganv_canvas_get_default_font_size(canvas);
+		this->font_size       = get_default_font_size();
+
+		_layouts.match_screen(gdk_screen_get_default());
 
 		this->idle_id         = 0;
 		this->root_destroy_id = g_signal_connect(
@@ -281,7 +964,29 @@ struct GanvCanvasImpl {
 		this->left_grabbed_item    = FALSE;
 		this->in_repick            = FALSE;
 		this->locked               = FALSE;
+		this->bundle_edges         = FALSE;
+		this->aggregate_edges      = FALSE;
 		this->exporting            = FALSE;
+		this->draw_stamp           = 1;
+
+		this->batch_depth            = 0;
+		this->batch_resized          = FALSE;
+		this->batch_redraw.x         = 0;
+		this->batch_redraw.y         = 0;
+		this->batch_redraw.width     = 0;
+		this->batch_redraw.height    = 0;
+		this->batch_contents_changed = FALSE;
+		this->batch_deferred_update  = FALSE;
+		this->content_changed        = FALSE;
+
+		this->generation      = 0;
+		this->position_stamp  = 1;
+		this->pick_item       = NULL;
+		this->pick_generation = 0;
+		this->pick_rect.x1    = 0.0;
+		this->pick_rect.y1    = 0.0;
+		this->pick_rect.x2    = 0.0;
+		this->pick_rect.y2    = 0.0;
 
 #ifdef GANV_FDGL
 		this->layout_idle_id = 0;
@@ -289,7 +994,8 @@ struct GanvCanvasImpl {
 		this->sprung_layout  = FALSE;
 #endif
 
-		_animate_idle_id = 0;
+		_animate_idle_id  = 0;
+		_relayout_idle_id = 0;
 
 		_port_order.port_cmp = NULL;
 		_port_order.data     = NULL;
@@ -313,13 +1019,31 @@ struct GanvCanvasImpl {
 			_animate_idle_id = 0;
 		}
 
+		if (_relayout_idle_id) {
+			g_source_remove(_relayout_idle_id);
+			_relayout_idle_id = 0;
+		}
+
 		while (g_idle_remove_by_data(this)) {}
 		ganv_canvas_clear(_gcanvas);
+		clear_update_queue();
+		remove_idle(_gcanvas);
 		gdk_cursor_unref(_move_cursor);
+		g_free(default_font);
+		if (default_font_desc) {
+			pango_font_description_free(default_font_desc);
+		}
 	}
 
 	static gboolean on_animate_timeout(gpointer impl);
 
+	static gboolean on_relayout_idle(gpointer impl);
+
+	bool relayout_stale_text(uint64_t budget);
+	void relayout_node(GanvNode* node);
+	void flush_stale_text();
+	bool get_content(DRect* content);
+
 #ifdef GANV_FDGL
 	static gboolean on_layout_timeout(gpointer impl) {
 		return ((GanvCanvasImpl*)impl)->layout_iteration();
@@ -335,18 +1059,34 @@ struct GanvCanvasImpl {
 
 	void unselect_ports();
 
+	/* Return the font that all text is based on */
+	const PangoFontDescription* get_base_font() const
+	{
+		if (default_font_desc) {
+			return default_font_desc;
+		}
+
+		return gtk_rc_get_style(GTK_WIDGET(_gcanvas))->font_desc;
+	}
+
+	double get_default_font_size() const
+	{
+		const PangoFontDescription* font = get_base_font();
+		return pango_font_description_get_size(font) / (double)PANGO_SCALE;
+	}
+
+	void invalidate_text();
+
 #ifdef HAVE_AGRAPH
 	GVNodes layout_dot(const std::string& filename);
 #endif
 
-	using Edges         = std::set<GanvEdge*, TailHeadOrder>;
-	using DstEdges      = std::set<GanvEdge*, HeadTailOrder>;
-	using SelectedEdges = std::set<GanvEdge*>;
+	using Edges         = std::unordered_map<EdgeKey, GanvEdge*, EdgeKeyHash>;
+	using Adjacency     = std::unordered_map<const GanvNode*, NodeEdges>;
+	using Cables        = std::unordered_map<EdgeKey, Cable, EdgeKeyHash>;
+	using SelectedEdges = ItemList<GanvEdge, _GanvEdgePrivate>;
 	using SelectedPorts = std::set<GanvPort*>;
 
-	Edges::const_iterator    first_edge_from(const GanvNode* src);
-	DstEdges::const_iterator first_edge_to(const GanvNode* dst);
-
 	void select_port(GanvPort* p, bool unique=false);
 	void select_port_toggle(GanvPort* p, int mod_state);
 	void unselect_port(GanvPort* p);
@@ -377,14 +1117,23 @@ struct GanvCanvasImpl {
 
 	void move_contents_to_internal(double x, double y, double min_x, double min_y);
 
+	void update_select_rect(const DRect& old_rect, const DRect& new_rect);
+	void finish_select_rect();
+
+	void process_update_queue();
+	void clear_update_queue();
+
 	GanvCanvas*   _gcanvas;
 	Ganv::Canvas* _wrapper;
 
 	Items         _items;       ///< Items on this canvas
-	Edges         _edges;       ///< Edges ordered (src, dst)
-	DstEdges      _dst_edges;   ///< Edges ordered (dst, src)
+	Edges         _edges;       ///< Edges by (tail, head)
+	Adjacency     _adjacency;   ///< Edges connected to each node
+	Cables        _cables;      ///< Edges between each pair of modules
+	EdgeKey       _hovered_cable; ///< Modules of the cable under the pointer
 	Items         _selected_items; ///< Currently selected items
 	SelectedEdges _selected_edges; ///< Currently selected edges
+	Items         _stale_text;     ///< Items laid out for an old font size
 
 	SelectedPorts _selected_ports; ///< Selected ports (hilited red)
 	GanvPort*     _connect_port; ///< Port for which a edge is being made
@@ -392,15 +1141,26 @@ struct GanvCanvasImpl {
 	GanvEdge*     _drag_edge;
 	GanvNode*     _drag_node;
 
+	SpatialIndex  _index;   ///< Top level items by area
+	ContentBounds _content; ///< Bounds of all top level nodes
+	LayoutCache   _layouts; ///< Text layouts shared between labels
+
+	std::vector<GanvItem*> _dirty_nodes; ///< Top level items to update
+	std::vector<GanvItem*> _dirty_edges; ///< Edges to update after items
+
 	GanvBox* _select_rect;     ///< Rectangle for drag selection
 	double   _select_start_x;  ///< Selection drag start x coordinate
 	double   _select_start_y;  ///< Selection drag start y coordinate
 
+	/// Items inside the selection rectangle, and whether it toggled them
+	std::map<GanvItem*, bool> _select_rect_items;
+
 	enum DragState { NOT_DRAGGING, EDGE, SCROLL, SELECT };
 	DragState      _drag_state;
 
 	GdkCursor* _move_cursor;
 	guint      _animate_idle_id;
+	guint      _relayout_idle_id;
 
 	PortOrderCtx _port_order;
 
@@ -449,6 +1209,12 @@ struct GanvCanvasImpl {
 	/* Font size in points */
 	double font_size;
 
+	/* Font set by the user, or NULL to use the widget style */
+	char* default_font;
+
+	/* Description of default_font, or the fallback if there is no display */
+	PangoFontDescription* default_font_desc;
+
 	/* Idle handler ID */
 	guint idle_id;
 
@@ -497,12 +1263,55 @@ struct GanvCanvasImpl {
 	/* For use by internal pick_current_item() function */
 	gboolean in_repick;
 
+	/* Number of nested batches in progress */
+	int batch_depth;
+
+	/* Whether the canvas was resized during the current batch */
+	gboolean batch_resized;
+
+	/* Bounds of all redraws requested during the current batch, if width > 0 */
+	IRect batch_redraw;
+
+	/* Whether contents changed during the current batch */
+	gboolean batch_contents_changed;
+
+	/* Whether the next update finishes a batch that deferred it */
+	gboolean batch_deferred_update;
+
+	/* Whether content bounds changed since the canvas was last expanded */
+	gboolean content_changed;
+
+	/* Incremented every time item geometry may have changed */
+	guint generation;
+
+	/* Incremented every time an item below the top level moves */
+	guint position_stamp;
+
+	/* Item that is known to be picked anywhere inside pick_rect */
+	GanvItem* pick_item;
+
+	/* Generation at which pick_rect was calculated */
+	guint pick_generation;
+
+	/* World rectangle around the pointer where pick_item is always hit */
+	DRect pick_rect;
+
 	/* Disable changes to canvas */
 	gboolean locked;
 
+	/* True if edges between the same modules are drawn as bundles */
+	gboolean bundle_edges;
+
+	/* True if edges between the same modules are collapsed into one cable */
+	gboolean aggregate_edges;
+
 	/* True if the current draw is an export */
 	gboolean exporting;
 
+	/* Incremented for every draw of the root, to know which edges have
+	   already been drawn with their bundle */
+	guint draw_stamp;
+
 #ifdef GANV_FDGL
 	guint    layout_idle_id;
 	gdouble  layout_energy;
@@ -510,67 +1319,198 @@ struct GanvCanvasImpl {
 #endif
 };
 
-struct GanvEdgeKey {
-	GanvItem         item;
-	GanvEdgePrivate* impl;
-	GanvEdgePrivate  impl_data;
-};
+static void
+erase_edge(std::vector<GanvEdge*>& edges, GanvEdge* edge)
+{
+	const std::vector<GanvEdge*>::iterator i = std::find(
+		edges.begin(), edges.end(), edge);
+	if (i != edges.end()) {
+		edges.erase(i);
+	}
+}
 
+/* Call f for each edge, which may add or remove any edges.  Like
+   ganv_canvas_for_each_edge(), this iterates over a referenced copy and skips
+   edges that have been removed, so each remaining edge is visited once. */
 static void
-make_edge_search_key(GanvEdgeKey*    key,
-                     const GanvNode* tail,
-                     const GanvNode* head)
+for_each_adjacent(GanvCanvasImpl*               impl,
+                  const std::vector<GanvEdge*>& adjacent,
+                  GanvEdgeFunc                  f,
+                  void*                         data)
 {
-	memset(key, '\0', sizeof(GanvEdgeKey));
-	key->impl = &key->impl_data;
-	key->impl->tail = const_cast<GanvNode*>(tail);
-	key->impl->head = const_cast<GanvNode*>(head);
+	const std::vector<GanvEdge*> edges(adjacent);
+	for (GanvEdge* edge : edges) {
+		g_object_ref(edge);
+	}
+
+	for (GanvEdge* edge : edges) {
+		const GanvCanvasImpl::Edges::const_iterator i =
+			impl->_edges.find(EdgeKey(edge->impl->tail, edge->impl->head));
+		if (i != impl->_edges.end() && i->second == edge) {
+			f(edge, data);
+		}
+		g_object_unref(edge);
+	}
 }
 
-GanvCanvasImpl::Edges::const_iterator
-GanvCanvasImpl::first_edge_from(const GanvNode* tail)
+/* Get the pair of modules an edge connects, which keys its cable */
+static bool
+get_cable_key(const GanvEdge* edge, EdgeKey* key)
 {
-	GanvEdgeKey key;
-	make_edge_search_key(&key, tail, NULL);
-	return _edges.lower_bound((GanvEdge*)&key);
+	const GanvNode* tail = edge->impl->tail;
+	const GanvNode* head = edge->impl->head;
+	if (!GANV_IS_PORT(tail) || !GANV_IS_PORT(head)) {
+		return false;
+	}
+
+	const GanvModule* tail_module = ganv_port_get_module(GANV_PORT(tail));
+	const GanvModule* head_module = ganv_port_get_module(GANV_PORT(head));
+
+	*key = EdgeKey(GANV_NODE(tail_module), GANV_NODE(head_module));
+	return tail_module != head_module;
 }
 
-GanvCanvasImpl::DstEdges::const_iterator
-GanvCanvasImpl::first_edge_to(const GanvNode* head)
+static bool
+cable_is_collapsed(const GanvCanvasImpl* impl, const Cable& cable)
 {
-	GanvEdgeKey key;
-	make_edge_search_key(&key, NULL, head);
-	return _dst_edges.lower_bound((GanvEdge*)&key);
+	return impl->aggregate_edges
+		&& cable.edges.size() > 1
+		&& cable.n_active == 0
+		&& !cable.hovered
+		&& impl->pixels_per_unit < CABLE_EXPAND_ZOOM;
 }
 
 static void
-select_if_tail_is_selected(GanvEdge* edge, void*)
+update_cable(const Cable& cable)
 {
-	GanvNode* tail     = edge->impl->tail;
-	gboolean  selected = FALSE;
-	g_object_get(tail, "selected", &selected, NULL);
-	if (!selected && GANV_IS_PORT(tail)) {
-		g_object_get(ganv_port_get_module(GANV_PORT(tail)),
-		             "selected", &selected, NULL);
+	for (GanvEdge* edge : cable.edges) {
+		ganv_item_request_update(GANV_ITEM(edge));
 	}
+}
 
-	if (selected) {
-		ganv_edge_select(edge);
+/* Update the edges of every cable with more than one edge */
+static void
+update_cables(const GanvCanvasImpl* impl)
+{
+	for (const auto& c : impl->_cables) {
+		if (c.second.edges.size() > 1) {
+			update_cable(c.second);
+		}
 	}
 }
 
+static gboolean
+edge_is_active(const GanvEdge* edge)
+{
+	return edge->impl->selected || edge->impl->highlighted;
+}
+
 static void
-select_if_head_is_selected(GanvEdge* edge, void*)
+add_to_cable(GanvCanvasImpl* impl, GanvEdge* edge)
 {
-	GanvNode* head     = edge->impl->head;
-	gboolean  selected = FALSE;
-	g_object_get(head, "selected", &selected, NULL);
-	if (!selected && GANV_IS_PORT(head)) {
-		g_object_get(ganv_port_get_module(GANV_PORT(head)),
-		             "selected", &selected, NULL);
+	EdgeKey modules;
+	if (!get_cable_key(edge, &modules)) {
+		return;
 	}
 
-	if (selected) {
+	Cable&     cable = impl->_cables[modules];
+	const bool was   = cable_is_collapsed(impl, cable);
+	cable.edges.push_back(edge);
+	cable.n_active += edge_is_active(edge) ? 1 : 0;
+	if (cable_is_collapsed(impl, cable) != was) {
+		update_cable(cable);
+	} else if (was) {
+		// Only the count drawn on the cable has changed
+		ganv_item_request_update(GANV_ITEM(cable.edges.front()));
+	}
+}
+
+static void
+remove_from_cable(GanvCanvasImpl* impl, GanvEdge* edge)
+{
+	EdgeKey modules;
+	if (!get_cable_key(edge, &modules)) {
+		return;
+	}
+
+	const GanvCanvasImpl::Cables::iterator c = impl->_cables.find(modules);
+	if (c == impl->_cables.end()) {
+		return;
+	}
+
+	Cable&     cable = c->second;
+	const bool was   = cable_is_collapsed(impl, cable);
+	erase_edge(cable.edges, edge);
+	if (edge_is_active(edge) && cable.n_active > 0) {
+		--cable.n_active;
+	}
+
+	if (cable.edges.empty()) {
+		if (modules == impl->_hovered_cable) {
+			impl->_hovered_cable = EdgeKey();
+		}
+		impl->_cables.erase(c);
+	} else if (cable_is_collapsed(impl, cable) != was) {
+		update_cable(cable);
+	} else if (was) {
+		// The count, and possibly the edge that draws it, has changed
+		ganv_item_request_update(GANV_ITEM(cable.edges.front()));
+	}
+}
+
+/* Set the selected flag of a node, without changing the canvas selection.
+   This bypasses the property setter, so notify here for property signals. */
+static void
+set_selected_flag(GanvNode* node, gboolean selected)
+{
+	if (node->impl->selected != selected) {
+		node->impl->selected = selected;
+		ganv_item_request_update(GANV_ITEM(node));
+		g_object_notify(G_OBJECT(node), "selected");
+	}
+}
+
+/* Set the selected flag of an edge, without changing the canvas selection */
+static void
+set_selected_flag(GanvCanvas* canvas, GanvEdge* edge, gboolean selected)
+{
+	if (edge->impl->selected != selected) {
+		const gboolean was_active = edge_is_active(edge);
+
+		edge->impl->selected = selected;
+		ganv_item_request_update(GANV_ITEM(edge));
+		if (edge_is_active(edge) != was_active) {
+			ganv_canvas_edge_activity_changed(canvas, edge, !was_active);
+		}
+		g_object_notify(G_OBJECT(edge), "selected");
+	}
+}
+
+/* Return true if a node, or the module it is on, is selected */
+static gboolean
+node_or_module_is_selected(const GanvNode* node)
+{
+	if (node->impl->selected) {
+		return TRUE;
+	} else if (GANV_IS_PORT(node)) {
+		const GanvModule* module = ganv_port_get_module(GANV_PORT(node));
+		return module && GANV_NODE(module)->impl->selected;
+	}
+	return FALSE;
+}
+
+static void
+select_if_tail_is_selected(GanvEdge* edge, void*)
+{
+	if (node_or_module_is_selected(edge->impl->tail)) {
+		ganv_edge_select(edge);
+	}
+}
+
+static void
+select_if_head_is_selected(GanvEdge* edge, void*)
+{
+	if (node_or_module_is_selected(edge->impl->head)) {
 		ganv_edge_set_selected(edge, TRUE);
 	}
 }
@@ -604,6 +1544,8 @@ gv_set(void* subject, const char* key, double value)
 GVNodes
 GanvCanvasImpl::layout_dot(const std::string& filename)
 {
+	flush_stale_text();
+
 	GVNodes nodes;
 
 	const double dpi = gdk_screen_get_resolution(gdk_screen_get_default());
@@ -761,7 +1703,7 @@ GanvCanvasImpl::layout_dot(const std::string& filename)
 	}
 
 	FOREACH_EDGE(_edges, i) {
-		const GanvEdge* const   edge   = *i;
+		const GanvEdge* const   edge   = i->second;
 		const GVNodes::iterator tail_i = nodes.find(edge->impl->tail);
 		const GVNodes::iterator head_i = nodes.find(edge->impl->head);
 
@@ -872,6 +1814,8 @@ GanvCanvasImpl::layout_iteration()
 		return FALSE;  // We shouldn't be running at all
 	}
 
+	flush_stale_text();
+
 	static const double T_PER_US = .0001;  // Sym time per real microsecond
 
 	static uint64_t prev = 0;  // Previous iteration time
@@ -906,7 +1850,7 @@ GanvCanvasImpl::layout_calculate(double dur, bool update)
 
 	// Calculate attractive spring forces for edges
 	FOREACH_EDGE(_edges, i) {
-		const GanvEdge* const edge = *i;
+		const GanvEdge* const edge = i->second;
 		if (!ganv_edge_get_constraining(edge)) {
 			continue;
 		}
@@ -1011,6 +1955,7 @@ GanvCanvasImpl::layout_calculate(double dur, bool update)
 
 			item->impl->x = std::max(MIN_COORD, item->impl->x + dpos.x);
 			item->impl->y = std::max(MIN_COORD, item->impl->y + dpos.y);
+			ganv_item_invalidate_offsets(item);
 
 			if (update) {
 				ganv_item_request_update(item);
@@ -1031,7 +1976,7 @@ GanvCanvasImpl::layout_calculate(double dur, bool update)
 	if (update) {
 		// Now update edge positions to reflect new node positions
 		FOREACH_EDGE(_edges, i) {
-			GanvEdge* const edge = *i;
+			GanvEdge* const edge = i->second;
 			ganv_edge_update_location(edge);
 		}
 	}
@@ -1056,8 +2001,7 @@ GanvCanvasImpl::select_port(GanvPort* p, bool unique)
 void
 GanvCanvasImpl::select_port_toggle(GanvPort* port, int mod_state)
 {
-	gboolean selected = FALSE;
-	g_object_get(G_OBJECT(port), "selected", &selected, NULL);
+	const gboolean selected = ganv_node_is_selected(GANV_NODE(port));
 	if ((mod_state & GDK_CONTROL_MASK)) {
 		if (selected)
 			unselect_port(port);
@@ -1330,47 +2274,23 @@ GanvCanvasImpl::select_drag_handler(GdkEvent* event)
 		double x = 0.0;
 		double y = 0.0;
 		get_motion_coords(&event->motion, &x, &y);
+
+		const GanvBoxCoords* coords   = &_select_rect->impl->coords;
+		const DRect          old_rect = { coords->x1, coords->y1,
+		                                  coords->x2, coords->y2 };
+
 		_select_rect->impl->coords.x1 = MIN(_select_start_x, x);
 		_select_rect->impl->coords.y1 = MIN(_select_start_y, y);
 		_select_rect->impl->coords.x2 = MAX(_select_start_x, x);
 		_select_rect->impl->coords.y2 = MAX(_select_start_y, y);
 		ganv_item_request_update(&_select_rect->node.item);
+
+		const DRect new_rect = { coords->x1, coords->y1, coords->x2, coords->y2 };
+		update_select_rect(old_rect, new_rect);
 		return true;
 	} else if (event->type == GDK_BUTTON_RELEASE && _drag_state == SELECT) {
-		// Normalize select rect
-		ganv_box_normalize(_select_rect);
-
-		// Select all modules within rect
-		FOREACH_ITEM(_items, i) {
-			GanvNode* node = *i;
-			if ((void*)node != (void*)_select_rect &&
-			    ganv_node_is_within(
-				    node,
-				    ganv_box_get_x1(_select_rect),
-				    ganv_box_get_y1(_select_rect),
-				    ganv_box_get_x2(_select_rect),
-				    ganv_box_get_y2(_select_rect))) {
-				gboolean selected = FALSE;
-				g_object_get(G_OBJECT(node), "selected", &selected, NULL);
-				if (selected) {
-					ganv_canvas_unselect_node(_gcanvas, node);
-				} else {
-					ganv_canvas_select_node(_gcanvas, node);
-				}
-			}
-		}
-
-		// Select all edges with handles within rect
-		FOREACH_EDGE(_edges, i) {
-			if (ganv_edge_is_within(
-				    (*i),
-				    ganv_box_get_x1(_select_rect),
-				    ganv_box_get_y1(_select_rect),
-				    ganv_box_get_x2(_select_rect),
-				    ganv_box_get_y2(_select_rect))) {
-				ganv_canvas_select_edge(_gcanvas, *i);
-			}
-		}
+		// Selection was updated while dragging, so just keep it
+		finish_select_rect();
 
 		ganv_canvas_ungrab_item(root, event->button.time);
 
@@ -1382,6 +2302,141 @@ GanvCanvasImpl::select_drag_handler(GdkEvent* event)
 	return false;
 }
 
+void
+GanvCanvasImpl::update_select_rect(const DRect& old_rect, const DRect& new_rect)
+{
+	/* Only items that overlap the area covered by one rectangle but not the
+	   other can have moved in or out of the selection, so query only that. */
+	const DRect hull = { std::min(old_rect.x1, new_rect.x1),
+	                     std::min(old_rect.y1, new_rect.y1),
+	                     std::max(old_rect.x2, new_rect.x2),
+	                     std::max(old_rect.y2, new_rect.y2) };
+	const DRect both = { std::max(old_rect.x1, new_rect.x1),
+	                     std::max(old_rect.y1, new_rect.y1),
+	                     std::min(old_rect.x2, new_rect.x2),
+	                     std::min(old_rect.y2, new_rect.y2) };
+
+	std::set<GanvItem*> candidates;
+	const auto collect = [&candidates](GanvItem* item) {
+		// Edges hidden in a cable are not drawn, so can not be selected
+		if (!GANV_IS_EDGE(item) || !GANV_EDGE(item)->impl->hidden) {
+			candidates.insert(item);
+		}
+	};
+
+	if (both.x1 >= both.x2 || both.y1 >= both.y2) {
+		_index.query(hull, collect);
+	} else {
+		const DRect strips[] = {
+			{ hull.x1, hull.y1, both.x1, hull.y2 },  // Left
+			{ both.x2, hull.y1, hull.x2, hull.y2 },  // Right
+			{ both.x1, hull.y1, both.x2, both.y1 },  // Top
+			{ both.x1, both.y2, both.x2, hull.y2 }   // Bottom
+		};
+		for (const DRect& strip : strips) {
+			if (strip.x1 < strip.x2 && strip.y1 < strip.y2) {
+				_index.query(strip, collect);
+			}
+		}
+	}
+
+	// Toggle items that entered the rectangle, and restore those that left
+	std::vector<GanvNode*> selected;
+	std::vector<GanvNode*> unselected;
+	for (GanvItem* item : candidates) {
+		if ((void*)item == (void*)_select_rect) {
+			continue;
+		}
+
+		bool within = false;
+		if (GANV_IS_NODE(item)) {
+			within = ganv_node_is_within(GANV_NODE(item),
+			                             new_rect.x1, new_rect.y1,
+			                             new_rect.x2, new_rect.y2);
+		} else if (GANV_IS_EDGE(item)) {
+			within = ganv_edge_is_within(GANV_EDGE(item),
+			                             new_rect.x1, new_rect.y1,
+			                             new_rect.x2, new_rect.y2);
+		}
+
+		const std::map<GanvItem*, bool>::iterator i = _select_rect_items.find(item);
+		const bool was_within = (i != _select_rect_items.end());
+		if (within == was_within) {
+			continue;
+		} else if (GANV_IS_NODE(item)) {
+			// Nodes are toggled while inside the rectangle
+			GanvNode* node = GANV_NODE(item);
+			if (node->impl->selected) {
+				unselected.push_back(node);
+			} else {
+				selected.push_back(node);
+			}
+		} else if (within) {
+			// Edges are only ever selected, and unselected again on leaving
+			GanvEdge*  edge    = GANV_EDGE(item);
+			const bool changed = !edge->impl->selected;
+			if (changed) {
+				ganv_canvas_select_edge(_gcanvas, edge);
+			}
+			_select_rect_items.insert(std::make_pair(item, changed));
+			continue;
+		} else if (i->second) {
+			ganv_canvas_unselect_edge(_gcanvas, GANV_EDGE(item));
+		}
+
+		if (within) {
+			_select_rect_items.insert(std::make_pair(item, true));
+		} else {
+			_select_rect_items.erase(i);
+		}
+	}
+
+	// Apply node selection changes together, after all state is consistent
+	for (GanvNode* node : unselected) {
+		ganv_canvas_unselect_node(_gcanvas, node);
+	}
+	for (GanvNode* node : selected) {
+		ganv_canvas_select_node(_gcanvas, node);
+	}
+}
+
+void
+GanvCanvasImpl::finish_select_rect()
+{
+	_select_rect_items.clear();
+}
+
+void
+GanvCanvasImpl::process_update_queue()
+{
+	std::vector<GanvItem*> items;
+	while (!_dirty_nodes.empty() || !_dirty_edges.empty()) {
+		// Update items first, since edge coordinates depend on them
+		items.clear();
+		items.swap(_dirty_nodes.empty() ? _dirty_edges : _dirty_nodes);
+
+		for (GanvItem* item : items) {
+			if (item->impl->canvas && item->impl->parent == root) {
+				ganv_item_invoke_update(item, 0);
+			}
+			g_object_unref(item);
+		}
+	}
+}
+
+void
+GanvCanvasImpl::clear_update_queue()
+{
+	for (GanvItem* item : _dirty_nodes) {
+		g_object_unref(item);
+	}
+	for (GanvItem* item : _dirty_edges) {
+		g_object_unref(item);
+	}
+	_dirty_nodes.clear();
+	_dirty_edges.clear();
+}
+
 bool
 GanvCanvasImpl::connect_drag_handler(GdkEvent* event)
 {
@@ -1475,8 +2530,12 @@ GanvCanvasImpl::end_connect_drag()
 	if (_connect_port) {
 		highlight_port(_connect_port, false);
 	}
-	gtk_object_destroy(GTK_OBJECT(_drag_edge));
-	gtk_object_destroy(GTK_OBJECT(_drag_node));
+	if (_drag_edge) {
+		gtk_object_destroy(GTK_OBJECT(_drag_edge));
+	}
+	if (_drag_node) {
+		gtk_object_destroy(GTK_OBJECT(_drag_node));
+	}
 	_drag_state   = NOT_DRAGGING;
 	_connect_port = NULL;
 	_drag_edge    = NULL;
@@ -1611,7 +2670,7 @@ GanvCanvasImpl::port_event(GdkEvent* event, GanvPort* port)
 		return true;
 
 	case GDK_ENTER_NOTIFY:
-		g_object_get(G_OBJECT(port), "selected", &selected, NULL);
+		selected = ganv_node_is_selected(GANV_NODE(port));
 		if (!control_dragging && !selected) {
 			highlight_port(port, true);
 			return true;
@@ -1720,13 +2779,149 @@ GanvCanvasImpl::on_animate_timeout(gpointer data)
 		ganv_node_tick(GANV_NODE(*p), seconds);
 	}
 
-	FOREACH_EDGE(impl->_selected_edges, c) {
+	FOREACH_SELECTED_EDGE(impl->_selected_edges, c) {
 		ganv_edge_tick(*c, seconds);
 	}
 
 	return TRUE;
 }
 
+/* Time to spend relaying out labels per frame, in microseconds. */
+static const uint64_t RELAYOUT_BUDGET = 8000;
+
+/* Relayout the labels of stale items for up to budget microseconds, or until
+   done if budget is zero.  Visible items are done first so the view settles
+   quickly, the rest are done in later slices.  Returns true if any remain. */
+bool
+GanvCanvasImpl::relayout_stale_text(uint64_t budget)
+{
+	const uint64_t start = get_monotonic_time();
+	const auto     spent = [budget, start]() {
+		return budget && get_monotonic_time() - start >= budget;
+	};
+
+	if (budget && GTK_WIDGET_REALIZED(_gcanvas)) {
+		const GtkAllocation& alloc = GTK_WIDGET(_gcanvas)->allocation;
+
+		DRect visible = { 0.0, 0.0, 0.0, 0.0 };
+		ganv_canvas_window_to_world(
+			_gcanvas, 0, 0, &visible.x1, &visible.y1);
+		ganv_canvas_window_to_world(
+			_gcanvas, alloc.width, alloc.height, &visible.x2, &visible.y2);
+
+		std::vector<GanvNode*> visible_nodes;
+		_index.query(visible, [this, &visible_nodes](GanvItem* item) {
+			if (GANV_IS_NODE(item) && _stale_text.contains(GANV_NODE(item))) {
+				visible_nodes.push_back(GANV_NODE(item));
+			}
+		});
+
+		for (GanvNode* node : visible_nodes) {
+			if (spent()) {
+				return true;
+			} else if (_stale_text.contains(node)) {
+				relayout_node(node);
+			}
+		}
+	}
+
+	// Erasing leaves holes, so the iterator stays valid
+	for (Items::const_iterator i = _stale_text.begin(); i != _stale_text.end();
+	     ++i) {
+		if (spent()) {
+			return true;
+		}
+		relayout_node(*i);
+	}
+
+	return false;
+}
+
+/* Relayout the labels of a stale node, and of the ports on it if any */
+void
+GanvCanvasImpl::relayout_node(GanvNode* node)
+{
+	_stale_text.erase(node);
+	if (GANV_IS_MODULE(node)) {
+		// Redrawing the text of a module redraws the text of its ports
+		GanvModule* const module = GANV_MODULE(node);
+		for (guint p = 0; p < ganv_module_num_ports(module); ++p) {
+			_stale_text.erase(GANV_NODE(ganv_module_get_port(module, p)));
+		}
+	}
+
+	ganv_node_redraw_text(node);
+}
+
+gboolean
+GanvCanvasImpl::on_relayout_idle(gpointer data)
+{
+	GanvCanvasImpl* impl = (GanvCanvasImpl*)data;
+	if (impl->relayout_stale_text(RELAYOUT_BUDGET)) {
+		return TRUE;
+	}
+
+	impl->_relayout_idle_id = 0;
+	return FALSE;
+}
+
+/* Mark all labels stale, relayout what is visible now and the rest later. */
+void
+GanvCanvasImpl::invalidate_text()
+{
+	_layouts.clear_masks();
+
+	FOREACH_ITEM(_items, i) {
+		_stale_text.insert(*i);
+	}
+
+	if (relayout_stale_text(RELAYOUT_BUDGET) && !_relayout_idle_id) {
+		// Finish the rest in idle slices between redraws
+		_relayout_idle_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+		                                    on_relayout_idle,
+		                                    this,
+		                                    NULL);
+	}
+}
+
+/* Relayout all stale labels and update, for things that need real sizes. */
+void
+GanvCanvasImpl::flush_stale_text()
+{
+	if (_stale_text.empty()) {
+		return;
+	}
+
+	relayout_stale_text(0);
+	if (need_update && !batch_depth) {
+		update_items(_gcanvas);
+	}
+}
+
+/* Get the bounds of all top level nodes, including any not yet updated. */
+bool
+GanvCanvasImpl::get_content(DRect* content)
+{
+	flush_stale_text();
+
+	/* Nodes created or moved since the last update are still queued, and the
+	   queue may not be processed until the canvas is mapped, so update them
+	   now.  Edges do not count towards the content, so they stay queued. */
+	std::vector<GanvItem*> items;
+	while (!_dirty_nodes.empty()) {
+		items.clear();
+		items.swap(_dirty_nodes);
+		for (GanvItem* item : items) {
+			if (item->impl->canvas && item->impl->parent == root) {
+				ganv_item_invoke_update(item, 0);
+			}
+			g_object_unref(item);
+		}
+	}
+
+	return _content.get(content);
+}
+
 void
 GanvCanvasImpl::move_contents_to_internal(double x, double y, double min_x, double min_y)
 {
@@ -1937,6 +3132,7 @@ ganv_canvas_class_init(GanvCanvasClass* klass)
 	widget_class->unmap                = ganv_canvas_unmap;
 	widget_class->realize              = ganv_canvas_realize;
 	widget_class->unrealize            = ganv_canvas_unrealize;
+	widget_class->screen_changed       = ganv_canvas_screen_changed;
 	widget_class->size_allocate        = ganv_canvas_size_allocate;
 	widget_class->button_press_event   = ganv_canvas_button;
 	widget_class->button_release_event = ganv_canvas_button;
@@ -2047,13 +3243,88 @@ ganv_canvas_resize(GanvCanvas* canvas, double width, double height)
 	if (width != canvas->impl->width || height != canvas->impl->height) {
 		canvas->impl->width  = width;
 		canvas->impl->height = height;
-		ganv_canvas_set_scroll_region(canvas, 0.0, 0.0, width, height);
+		if (canvas->impl->batch_depth) {
+			canvas->impl->batch_resized = TRUE;
+		} else {
+			ganv_canvas_set_scroll_region(canvas, 0.0, 0.0, width, height);
+		}
+	}
+}
+
+void
+ganv_canvas_begin_batch(GanvCanvas* canvas)
+{
+	++canvas->impl->batch_depth;
+}
+
+/* Finish a batch.  If update is false, items are left to be updated by the
+   idle handler, which does so in a batch of its own so redraws still merge. */
+static void
+end_batch(GanvCanvas* canvas, gboolean update)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+
+	g_return_if_fail(impl->batch_depth > 0);
+	if (impl->batch_depth > 1) {
+		--impl->batch_depth;
+		return;
+	}
+
+	if (impl->need_update && !update) {
+		impl->batch_deferred_update = TRUE;
+	} else if (impl->need_update && GTK_WIDGET_MAPPED(GTK_WIDGET(canvas))) {
+		// Update items while still batched, so any side effects are merged too
+		update_items(canvas);
 	}
+
+	impl->batch_depth = 0;
+
+	const gboolean resized = impl->batch_resized;
+	if (resized) {
+		impl->batch_resized = FALSE;
+		ganv_canvas_set_scroll_region(canvas, 0.0, 0.0, impl->width, impl->height);
+	}
+
+	if (impl->batch_contents_changed) {
+		impl->batch_contents_changed = FALSE;
+		ganv_canvas_contents_changed(canvas);
+	}
+
+	if (impl->batch_redraw.width > 0) {
+		const IRect r = impl->batch_redraw;
+		impl->batch_redraw.width = 0;
+		if (resized) {
+			// Canvas coordinates have changed, so redraw everything
+			ganv_canvas_request_redraw_w(canvas,
+			                             impl->scroll_x1, impl->scroll_y1,
+			                             impl->scroll_x2, impl->scroll_y2);
+		} else {
+			ganv_canvas_request_redraw_c(
+				canvas, r.x, r.y, r.x + r.width, r.y + r.height);
+		}
+	}
+
+	if (impl->need_update && GTK_WIDGET_MAPPED(GTK_WIDGET(canvas))) {
+		add_idle(canvas);
+	}
+
+	impl->need_repick = TRUE;
+}
+
+void
+ganv_canvas_end_batch(GanvCanvas* canvas)
+{
+	end_batch(canvas, TRUE);
 }
 
 void
 ganv_canvas_contents_changed(GanvCanvas* canvas)
 {
+	if (canvas->impl->batch_depth) {
+		canvas->impl->batch_contents_changed = TRUE;
+		return;
+	}
+
 #ifdef GANV_FDGL
 	if (!canvas->impl->layout_idle_id && canvas->impl->sprung_layout) {
 		canvas->impl->layout_energy = 0.4;
@@ -2070,9 +3341,49 @@ ganv_canvas_contents_changed(GanvCanvas* canvas)
 double
 ganv_canvas_get_default_font_size(const GanvCanvas* canvas)
 {
-	GtkStyle*                   style = gtk_rc_get_style(GTK_WIDGET(canvas));
-	const PangoFontDescription* font  = style->font_desc;
-	return pango_font_description_get_size(font) / (double)PANGO_SCALE;
+	return canvas->impl->get_default_font_size();
+}
+
+const char*
+ganv_canvas_get_default_font(const GanvCanvas* canvas)
+{
+	return canvas->impl->default_font;
+}
+
+void
+ganv_canvas_set_default_font(GanvCanvas* canvas, const char* font)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+
+	g_free(impl->default_font);
+	if (impl->default_font_desc) {
+		pango_font_description_free(impl->default_font_desc);
+	}
+
+	impl->default_font      = font ? g_strdup(font) : NULL;
+	impl->default_font_desc = NULL;
+	if (font || !gdk_screen_get_default()) {
+		PangoFontDescription* fallback =
+			pango_font_description_from_string(GANV_FALLBACK_FONT);
+
+		// Fill in anything the given font doesn't specify, like the size
+		impl->default_font_desc =
+			pango_font_description_from_string(font ? font : "");
+		pango_font_description_merge(impl->default_font_desc, fallback, FALSE);
+		pango_font_description_free(fallback);
+	}
+
+	if (font) {
+		// Use the size of the given font, if it has one
+		PangoFontDescription* desc = pango_font_description_from_string(font);
+		if (pango_font_description_get_set_fields(desc) & PANGO_FONT_MASK_SIZE) {
+			impl->font_size = std::max(
+				pango_font_description_get_size(desc) / (double)PANGO_SCALE, 1.0);
+		}
+		pango_font_description_free(desc);
+	}
+
+	impl->invalidate_text();
 }
 
 double
@@ -2081,6 +3392,39 @@ ganv_canvas_get_font_size(const GanvCanvas* canvas)
 	return canvas->impl->font_size;
 }
 
+PangoLayout*
+ganv_canvas_get_layout(GanvCanvas* canvas,
+                       const char* text,
+                       double      points,
+                       int*        width,
+                       int*        height)
+{
+	return canvas->impl->_layouts.get(
+		canvas->impl->get_base_font(), text, points, width, height);
+}
+
+void
+ganv_canvas_release_layout(GanvCanvas* canvas, PangoLayout* layout)
+{
+	canvas->impl->_layouts.release(layout);
+}
+
+void
+ganv_canvas_draw_layout(GanvCanvas*  canvas,
+                        cairo_t*     cr,
+                        PangoLayout* layout,
+                        double       x,
+                        double       y)
+{
+	if (canvas->impl->exporting) {
+		// Keep text as text in vector output
+		cairo_move_to(cr, x, y);
+		pango_cairo_show_layout(cr, layout);
+	} else {
+		canvas->impl->_layouts.draw(cr, layout, x, y);
+	}
+}
+
 void
 ganv_canvas_set_zoom(GanvCanvas* canvas, double zoom)
 {
@@ -2116,9 +3460,17 @@ ganv_canvas_set_zoom(GanvCanvas* canvas, double zoom)
 	const int x1 = ((ax - canvas->impl->scroll_x1) * zoom) - anchor_x;
 	const int y1 = ((ay - canvas->impl->scroll_y1) * zoom) - anchor_y;
 
+	const bool was_expanded = canvas->impl->pixels_per_unit >= CABLE_EXPAND_ZOOM;
+
 	canvas->impl->pixels_per_unit = zoom;
+	canvas->impl->_layouts.clear_masks();
 	ganv_canvas_scroll_to(canvas, x1, y1);
 
+	if (canvas->impl->aggregate_edges
+	    && (zoom >= CABLE_EXPAND_ZOOM) != was_expanded) {
+		update_cables(canvas->impl);
+	}
+
 	ganv_canvas_request_update(canvas);
 	gtk_widget_queue_draw(GTK_WIDGET(canvas));
 
@@ -2131,17 +3483,18 @@ ganv_canvas_set_font_size(GanvCanvas* canvas, double points)
 	points = std::max(points, 1.0);
 	if (points != canvas->impl->font_size) {
 		canvas->impl->font_size = points;
-		FOREACH_ITEM(canvas->impl->_items, i) {
-			ganv_node_redraw_text(*i);
-		}
+		canvas->impl->invalidate_text();
 	}
 }
 
 void
 ganv_canvas_zoom_full(GanvCanvas* canvas)
 {
-	if (canvas->impl->_items.empty())
+	// Box containing all canvas items
+	DRect content;
+	if (!canvas->impl->get_content(&content)) {
 		return;
+	}
 
 	int win_width  = 0;
 	int win_height = 0;
@@ -2149,42 +3502,18 @@ ganv_canvas_zoom_full(GanvCanvas* canvas)
 		GTK_WIDGET(canvas->impl->_gcanvas));
 	gdk_window_get_size(win, &win_width, &win_height);
 
-	// Box containing all canvas items
-	double left   = DBL_MAX;
-	double right  = DBL_MIN;
-	double top    = DBL_MIN;
-	double bottom = DBL_MAX;
-
-	FOREACH_ITEM(canvas->impl->_items, i) {
-		GanvItem* const item = GANV_ITEM(*i);
-		const double    x    = item->impl->x;
-		const double    y    = item->impl->y;
-		if (GANV_IS_CIRCLE(*i)) {
-			const double r = GANV_CIRCLE(*i)->impl->coords.radius;
-			left   = MIN(left, x - r);
-			right  = MAX(right, x + r);
-			bottom = MIN(bottom, y - r);
-			top    = MAX(top, y + r);
-		} else {
-			left   = MIN(left, x);
-			right  = MAX(right, x + ganv_box_get_width(GANV_BOX(*i)));
-			bottom = MIN(bottom, y);
-			top    = MAX(top, y + ganv_box_get_height(GANV_BOX(*i)));
-		}
-	}
-
 	static const double pad = GANV_CANVAS_PAD;
 
 	const double new_zoom = std::min(
-		((double)win_width / (double)(right - left + pad*2.0)),
-		((double)win_height / (double)(top - bottom + pad*2.0)));
+		((double)win_width / (content.x2 - content.x1 + pad*2.0)),
+		((double)win_height / (content.y2 - content.y1 + pad*2.0)));
 
 	ganv_canvas_set_zoom(canvas, new_zoom);
 
 	int scroll_x = 0;
 	int scroll_y = 0;
 	ganv_canvas_w2c(canvas->impl->_gcanvas,
-	                lrintf(left - pad), lrintf(bottom - pad),
+	                lrintf(content.x1 - pad), lrintf(content.y1 - pad),
 	                &scroll_x, &scroll_y);
 
 	ganv_canvas_scroll_to(canvas->impl->_gcanvas,
@@ -2200,7 +3529,7 @@ set_node_direction(GanvNode* node, void* data)
 }
 
 GanvDirection
-ganv_canvas_get_direction(GanvCanvas* canvas)
+ganv_canvas_get_direction(const GanvCanvas* canvas)
 {
 	return canvas->impl->direction;
 }
@@ -2218,19 +3547,20 @@ ganv_canvas_set_direction(GanvCanvas* canvas, GanvDirection dir)
 void
 ganv_canvas_clear_selection(GanvCanvas* canvas)
 {
-	canvas->impl->unselect_ports();
+	GanvCanvasImpl* impl = canvas->impl;
 
-	const Items items{canvas->impl->_selected_items};
-	canvas->impl->_selected_items.clear();
-	FOREACH_ITEM(items, i) {
-		ganv_item_set(GANV_ITEM(*i), "selected", FALSE, NULL);
+	impl->unselect_ports();
+
+	// Selected edges are all in the list, so just clear flags
+	FOREACH_ITEM(impl->_selected_items, i) {
+		set_selected_flag(*i, FALSE);
 	}
+	impl->_selected_items.clear();
 
-	const GanvCanvasImpl::SelectedEdges edges{canvas->impl->_selected_edges};
-	canvas->impl->_selected_edges.clear();
-	FOREACH_SELECTED_EDGE(edges, c) {
-		ganv_item_set(GANV_ITEM(*c), "selected", FALSE, NULL);
+	FOREACH_SELECTED_EDGE(impl->_selected_edges, c) {
+		set_selected_flag(canvas, *c, FALSE);
 	}
+	impl->_selected_edges.clear();
 }
 
 void
@@ -2238,11 +3568,21 @@ ganv_canvas_move_selected_items(GanvCanvas* canvas,
                                 double      dx,
                                 double      dy)
 {
-	FOREACH_ITEM(canvas->impl->_selected_items, i) {
-		if ((*i)->item.impl->parent == canvas->impl->root) {
+	GanvCanvasImpl* impl = canvas->impl;
+	if (dx == 0.0 && dy == 0.0) {
+		return;
+	}
+
+	/* Move every node in one batch, so edges shared between them are updated
+	   once.  Motion events can arrive faster than frames, so the update is
+	   left to the idle handler, which redraws everything in one rectangle. */
+	ganv_canvas_begin_batch(canvas);
+	FOREACH_ITEM(impl->_selected_items, i) {
+		if ((*i)->item.impl->parent == impl->root) {
 			ganv_node_move(*i, dx, dy);
 		}
 	}
+	end_batch(canvas, FALSE);
 }
 
 void
@@ -2285,7 +3625,11 @@ void
 ganv_canvas_select_node(GanvCanvas* canvas,
                         GanvNode*   node)
 {
-	canvas->impl->_selected_items.insert(node);
+	if (!canvas->impl->_selected_items.insert(node)) {
+		return;  // Already selected
+	}
+
+	set_selected_flag(node, TRUE);
 
 	// Select any connections to or from this node
 	if (GANV_IS_MODULE(node)) {
@@ -2294,8 +3638,6 @@ ganv_canvas_select_node(GanvCanvas* canvas,
 		ganv_canvas_for_each_edge_on(
 			canvas, node, select_if_ends_are_selected, canvas->impl);
 	}
-
-	g_object_set(node, "selected", TRUE, NULL);
 }
 
 void
@@ -2312,7 +3654,7 @@ ganv_canvas_unselect_node(GanvCanvas* canvas,
 
 	// Unselect item
 	canvas->impl->_selected_items.erase(node);
-	g_object_set(node, "selected", FALSE, NULL);
+	set_selected_flag(node, FALSE);
 }
 
 void
@@ -2350,6 +3692,8 @@ ganv_canvas_remove_node(GanvCanvas* canvas,
 
 	// Remove from items
 	canvas->impl->_items.erase(node);
+	canvas->impl->_stale_text.erase(node);
+	canvas->impl->_adjacency.erase(node);
 }
 
 GanvEdge*
@@ -2357,11 +3701,9 @@ ganv_canvas_get_edge(GanvCanvas* canvas,
                      GanvNode*   tail,
                      GanvNode*   head)
 {
-	GanvEdgeKey key;
-	make_edge_search_key(&key, tail, head);
-
-	const GanvCanvasImpl::Edges::const_iterator i = canvas->impl->_edges.find((GanvEdge*)&key);
-	return (i != canvas->impl->_edges.end()) ? *i : NULL;
+	const GanvCanvasImpl::Edges::const_iterator i =
+		canvas->impl->_edges.find(EdgeKey(tail, head));
+	return (i != canvas->impl->_edges.end()) ? i->second : NULL;
 }
 
 void
@@ -2372,6 +3714,71 @@ ganv_canvas_remove_edge_between(GanvCanvas* canvas,
 	ganv_canvas_remove_edge(canvas, ganv_canvas_get_edge(canvas, tail, head));
 }
 
+void
+ganv_canvas_add_graph(GanvCanvas*         canvas,
+                      const GanvNodeSpec* nodes,
+                      guint               n_nodes,
+                      const GanvEdgeSpec* edges,
+                      guint               n_edges,
+                      GanvNode**          nodes_out,
+                      GanvEdge**          edges_out)
+{
+	GanvCanvasImpl*        impl = canvas->impl;
+	std::vector<GanvNode*> created(n_nodes, NULL);
+
+	// Size the edge indices once, rather than rehashing as edges are added
+	impl->_edges.reserve(impl->_edges.size() + n_edges);
+	impl->_adjacency.reserve(impl->_adjacency.size() + n_nodes);
+
+	ganv_canvas_begin_batch(canvas);
+
+	// Set fields with typed accessors, since parsing properties is slow
+	for (guint i = 0; i < n_nodes; ++i) {
+		const GanvNodeSpec& spec = nodes[i];
+		GanvNode*           node = NULL;
+		if (spec.module < 0) {
+			node = GANV_NODE(ganv_module_new(canvas, NULL));
+			ganv_node_move_to(node, spec.x, spec.y);
+		} else if ((guint)spec.module < i && created[spec.module]
+		           && GANV_IS_MODULE(created[spec.module])) {
+			node = GANV_NODE(ganv_port_new(GANV_MODULE(created[spec.module]),
+			                               spec.is_input,
+			                               NULL));
+		} else {
+			g_warning("Port %u has invalid module %d", i, spec.module);
+			continue;
+		}
+
+		if (spec.label) {
+			ganv_node_set_label(node, spec.label);
+		}
+		created[i] = node;
+	}
+
+	for (guint i = 0; i < n_edges; ++i) {
+		const GanvEdgeSpec& spec = edges[i];
+		GanvEdge*           edge = NULL;
+		if (spec.tail < n_nodes && created[spec.tail]
+		    && spec.head < n_nodes && created[spec.head]) {
+			edge = ganv_edge_new(
+				canvas, created[spec.tail], created[spec.head], NULL);
+		} else {
+			g_warning("Edge %u has invalid nodes %u => %u",
+			          i, spec.tail, spec.head);
+		}
+
+		if (edges_out) {
+			edges_out[i] = edge;
+		}
+	}
+
+	ganv_canvas_end_batch(canvas);
+
+	if (nodes_out) {
+		std::copy(created.begin(), created.end(), nodes_out);
+	}
+}
+
 void
 ganv_canvas_disconnect_edge(GanvCanvas* canvas,
                             GanvEdge*   edge)
@@ -2384,8 +3791,13 @@ void
 ganv_canvas_add_edge(GanvCanvas* canvas,
                      GanvEdge*   edge)
 {
-	canvas->impl->_edges.insert(edge);
-	canvas->impl->_dst_edges.insert(edge);
+	GanvCanvasImpl* impl = canvas->impl;
+	const EdgeKey   key(edge->impl->tail, edge->impl->head);
+	if (impl->_edges.insert(std::make_pair(key, edge)).second) {
+		impl->_adjacency[edge->impl->tail].out.push_back(edge);
+		impl->_adjacency[edge->impl->head].in.push_back(edge);
+		add_to_cable(impl, edge);
+	}
 	ganv_canvas_contents_changed(canvas);
 }
 
@@ -2394,9 +3806,25 @@ ganv_canvas_remove_edge(GanvCanvas* canvas,
                         GanvEdge*   edge)
 {
 	if (edge) {
-		canvas->impl->_selected_edges.erase(edge);
-		canvas->impl->_edges.erase(edge);
-		canvas->impl->_dst_edges.erase(edge);
+		GanvCanvasImpl* impl = canvas->impl;
+		const EdgeKey   key(edge->impl->tail, edge->impl->head);
+		const GanvCanvasImpl::Edges::iterator i = impl->_edges.find(key);
+		if (i != impl->_edges.end() && i->second == edge) {
+			impl->_edges.erase(i);
+			const GanvCanvasImpl::Adjacency::iterator t =
+				impl->_adjacency.find(edge->impl->tail);
+			if (t != impl->_adjacency.end()) {
+				erase_edge(t->second.out, edge);
+			}
+			const GanvCanvasImpl::Adjacency::iterator h =
+				impl->_adjacency.find(edge->impl->head);
+			if (h != impl->_adjacency.end()) {
+				erase_edge(h->second.in, edge);
+			}
+			remove_from_cable(impl, edge);
+		}
+
+		impl->_selected_edges.erase(edge);
 		ganv_edge_request_redraw(GANV_ITEM(edge), &edge->impl->coords);
 		gtk_object_destroy(GTK_OBJECT(edge));
 		ganv_canvas_contents_changed(canvas);
@@ -2407,16 +3835,16 @@ void
 ganv_canvas_select_edge(GanvCanvas* canvas,
                         GanvEdge*   edge)
 {
-	ganv_item_set(GANV_ITEM(edge), "selected", TRUE, NULL);
 	canvas->impl->_selected_edges.insert(edge);
+	set_selected_flag(canvas, edge, TRUE);
 }
 
 void
 ganv_canvas_unselect_edge(GanvCanvas* canvas,
                           GanvEdge*   edge)
 {
-	ganv_item_set(GANV_ITEM(edge), "selected", FALSE, NULL);
 	canvas->impl->_selected_edges.erase(edge);
+	set_selected_flag(canvas, edge, FALSE);
 }
 
 void
@@ -2451,12 +3879,23 @@ ganv_canvas_for_each_edge(GanvCanvas*  canvas,
                           void*        data)
 {
 	GanvCanvasImpl* impl = canvas->impl;
-	for (GanvCanvasImpl::Edges::const_iterator i = impl->_edges.begin();
-	     i != impl->_edges.end();) {
-		GanvCanvasImpl::Edges::const_iterator next = i;
-		++next;
-		f((*i), data);
-		i = next;
+
+	/* Iterate over a snapshot, since f may add or remove edges, which can
+	   rehash the index.  Edges are referenced so removed ones can be skipped. */
+	std::vector<GanvEdge*> edges;
+	edges.reserve(impl->_edges.size());
+	FOREACH_EDGE(impl->_edges, i) {
+		edges.push_back(i->second);
+		g_object_ref(i->second);
+	}
+
+	for (GanvEdge* edge : edges) {
+		const GanvCanvasImpl::Edges::const_iterator i =
+			impl->_edges.find(EdgeKey(edge->impl->tail, edge->impl->head));
+		if (i != impl->_edges.end() && i->second == edge) {
+			f(edge, data);
+		}
+		g_object_unref(edge);
 	}
 }
 
@@ -2467,12 +3906,9 @@ ganv_canvas_for_each_edge_from(GanvCanvas*     canvas,
                                void*           data)
 {
 	GanvCanvasImpl* impl = canvas->impl;
-	for (GanvCanvasImpl::Edges::const_iterator i = impl->first_edge_from(tail);
-	     i != impl->_edges.end() && (*i)->impl->tail == tail;) {
-		GanvCanvasImpl::Edges::const_iterator next = i;
-		++next;
-		f((*i), data);
-		i = next;
+	const GanvCanvasImpl::Adjacency::iterator a = impl->_adjacency.find(tail);
+	if (a != impl->_adjacency.end()) {
+		for_each_adjacent(impl, a->second.out, f, data);
 	}
 }
 
@@ -2483,12 +3919,9 @@ ganv_canvas_for_each_edge_to(GanvCanvas*     canvas,
                              void*           data)
 {
 	GanvCanvasImpl* impl = canvas->impl;
-	for (GanvCanvasImpl::Edges::const_iterator i = impl->first_edge_to(head);
-	     i != impl->_dst_edges.end() && (*i)->impl->head == head;) {
-		GanvCanvasImpl::Edges::const_iterator next = i;
-		++next;
-		f((*i), data);
-		i = next;
+	const GanvCanvasImpl::Adjacency::iterator a = impl->_adjacency.find(head);
+	if (a != impl->_adjacency.end()) {
+		for_each_adjacent(impl, a->second.in, f, data);
 	}
 }
 
@@ -2507,7 +3940,7 @@ ganv_canvas_for_each_selected_edge(GanvCanvas*  canvas,
                                    GanvEdgeFunc f,
                                    void*        data)
 {
-	FOREACH_EDGE(canvas->impl->_selected_edges, i) {
+	FOREACH_SELECTED_EDGE(canvas->impl->_selected_edges, i) {
 		f((*i), data);
 	}
 }
@@ -2523,38 +3956,76 @@ ganv_canvas_port_event(GanvCanvas* canvas,
                        GanvPort*   port,
                        GdkEvent*   event)
 {
-	return canvas->impl->port_event(event, port);
+	return canvas->impl->port_event(event, port);
+}
+
+static gboolean
+is_real_edge(GanvItem* item)
+{
+	return GANV_IS_EDGE(item) && !GANV_EDGE(item)->impl->ghost;
+}
+
+static gboolean
+is_node(GanvItem* item)
+{
+	return GANV_IS_NODE(item);
 }
 
 void
 ganv_canvas_clear(GanvCanvas* canvas)
 {
-	canvas->impl->_selected_items.clear();
-	canvas->impl->_selected_edges.clear();
+	GanvCanvasImpl* impl = canvas->impl;
 
-	const Items items = canvas->impl->_items; // copy
-	FOREACH_ITEM(items, i) {
-		gtk_object_destroy(GTK_OBJECT(*i));
+	// Redraw everything once at the end instead of every item as it goes
+	ganv_canvas_begin_batch(canvas);
+
+	/* Cancel any connection in progress now, since ending it destroys the
+	   temporary edge and node which the bulk teardown below may have saved as
+	   the next item to visit */
+	if (impl->_drag_state == GanvCanvasImpl::EDGE) {
+		ganv_canvas_ungrab_item(ganv_canvas_root(canvas), 0);
+		impl->end_connect_drag();
 	}
-	canvas->impl->_items.clear();
+	impl->_connect_port = NULL;
+
+	// Forget everything first so destroyed items don't search for themselves
+	impl->_selected_items.clear();
+	impl->_selected_edges.clear();
+	impl->_selected_ports.clear();
+	impl->_select_rect_items.clear();
+	impl->_items.clear();
+	impl->_stale_text.clear();
+	impl->_edges.clear();
+	impl->_adjacency.clear();
+	impl->_cables.clear();
+	impl->_hovered_cable = EdgeKey();
+	impl->_index.clear();
+	impl->_content.clear();
 
-	const GanvCanvasImpl::Edges edges = canvas->impl->_edges; // copy
-	FOREACH_EDGE(edges, i) {
-		gtk_object_destroy(GTK_OBJECT(*i));
+	if (impl->root) {
+		// Edges first, so they never refer to destroyed nodes
+		GanvGroup* root = GANV_GROUP(impl->root);
+		ganv_group_destroy_children(root, is_real_edge);
+		ganv_group_destroy_children(root, is_node);
 	}
-	canvas->impl->_edges.clear();
-	canvas->impl->_dst_edges.clear();
 
-	canvas->impl->_selected_ports.clear();
-	canvas->impl->_connect_port = NULL;
+	ganv_canvas_end_batch(canvas);
 }
 
 void
 ganv_canvas_select_all(GanvCanvas* canvas)
 {
+	GanvCanvasImpl* impl = canvas->impl;
+
 	ganv_canvas_clear_selection(canvas);
-	FOREACH_ITEM(canvas->impl->_items, i) {
-		ganv_canvas_select_node(canvas, *i);
+	FOREACH_ITEM(impl->_items, i) {
+		impl->_selected_items.insert(*i);
+		set_selected_flag(*i, TRUE);
+	}
+
+	// Every edge is now between selected nodes, so select them in one pass
+	FOREACH_EDGE(impl->_edges, e) {
+		ganv_canvas_select_edge(canvas, e->second);
 	}
 }
 
@@ -2567,15 +4038,27 @@ ganv_canvas_get_zoom(const GanvCanvas* canvas)
 void
 ganv_canvas_move_contents_to(GanvCanvas* canvas, double x, double y)
 {
-	double min_x = HUGE_VAL;
-	double min_y = HUGE_VAL;
-	FOREACH_ITEM(canvas->impl->_items, i) {
-		const double x = GANV_ITEM(*i)->impl->x;
-		const double y = GANV_ITEM(*i)->impl->y;
-		min_x = std::min(min_x, x);
-		min_y = std::min(min_y, y);
+	DRect content;
+	if (canvas->impl->get_content(&content)) {
+		canvas->impl->move_contents_to_internal(x, y, content.x1, content.y1);
+	}
+}
+
+gboolean
+ganv_canvas_get_content_bounds(const GanvCanvas* canvas,
+                               double* x1, double* y1,
+                               double* x2, double* y2)
+{
+	DRect content;
+	if (!canvas->impl->get_content(&content)) {
+		return FALSE;
 	}
-	canvas->impl->move_contents_to_internal(x, y, min_x, min_y);
+
+	*x1 = content.x1;
+	*y1 = content.y1;
+	*x2 = content.x2;
+	*y2 = content.y2;
+	return TRUE;
 }
 
 void
@@ -2649,10 +4132,7 @@ ganv_canvas_arrange(GanvCanvas* canvas)
 
 	double old_width  = 0.0;
 	double old_height = 0.0;
-	g_object_get(G_OBJECT(canvas),
-	             "width", &old_width,
-	             "height", &old_height,
-	             NULL);
+	ganv_canvas_get_size(canvas, &old_width, &old_height);
 
 	const double new_width  = std::max(graph_width + 10.0, old_width);
 	const double new_height = std::max(graph_height + 10.0, old_height);
@@ -2688,12 +4168,15 @@ ganv_canvas_export_image(GanvCanvas* canvas,
 		return 0;
 	}
 
+	canvas->impl->flush_stale_text();
+
 	cairo_surface_t* rec_surface = cairo_recording_surface_create(
 		CAIRO_CONTENT_COLOR_ALPHA, NULL);
 
 	// Draw to recording surface
 	cairo_t* cr = cairo_create(rec_surface);
 	canvas->impl->exporting = TRUE;
+	++canvas->impl->draw_stamp;
 	(*GANV_ITEM_GET_CLASS(canvas->impl->root)->draw)(
 		canvas->impl->root, cr,
 		0, 0, canvas->impl->width, canvas->impl->height);
@@ -2783,6 +4266,194 @@ ganv_canvas_get_locked(const GanvCanvas* canvas)
 	return canvas->impl->locked;
 }
 
+gboolean
+ganv_canvas_get_bundle_edges(const GanvCanvas* canvas)
+{
+	return canvas->impl->bundle_edges;
+}
+
+void
+ganv_canvas_set_bundle_edges(GanvCanvas* canvas, gboolean bundle_edges)
+{
+	if (canvas->impl->bundle_edges != bundle_edges) {
+		canvas->impl->bundle_edges = bundle_edges;
+		ganv_canvas_for_each_edge(
+			canvas, (GanvEdgeFunc)ganv_edge_update_location, NULL);
+	}
+}
+
+gboolean
+ganv_canvas_get_aggregate_edges(const GanvCanvas* canvas)
+{
+	return canvas->impl->aggregate_edges;
+}
+
+void
+ganv_canvas_set_aggregate_edges(GanvCanvas* canvas, gboolean aggregate_edges)
+{
+	if (canvas->impl->aggregate_edges != aggregate_edges) {
+		canvas->impl->aggregate_edges = aggregate_edges;
+		update_cables(canvas->impl);
+	}
+}
+
+/* Expand a collapsed cable while the pointer is over it or its edges */
+static void
+hover_cable(GanvCanvas* canvas, double x, double y)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+
+	const GanvCanvasImpl::Cables::iterator h =
+		impl->_cables.find(impl->_hovered_cable);
+	if (h != impl->_cables.end()) {
+		// Keep it expanded while the pointer is near any of its edges
+		const double pad = GANV_CANVAS_PAD;
+		for (const GanvEdge* edge : h->second.edges) {
+			const GanvItemPrivate* e = GANV_ITEM(edge)->impl;
+			if (x >= e->x1 - pad && x <= e->x2 + pad &&
+			    y >= e->y1 - pad && y <= e->y2 + pad) {
+				return;
+			}
+		}
+
+		Cable& cable = h->second;
+		impl->_hovered_cable = EdgeKey();
+		cable.hovered        = false;
+		if (cable_is_collapsed(impl, cable)) {
+			update_cable(cable);
+		}
+	}
+
+	// Expand a collapsed cable when the pointer enters the edge drawing it
+	GanvItem* item = impl->current_item;
+	EdgeKey   modules;
+	if (item && GANV_IS_EDGE(item) && GANV_EDGE(item)->impl->cable_size > 0 &&
+	    get_cable_key(GANV_EDGE(item), &modules)) {
+		const GanvCanvasImpl::Cables::iterator c = impl->_cables.find(modules);
+		if (c != impl->_cables.end() && cable_is_collapsed(impl, c->second)) {
+			impl->_hovered_cable = modules;
+			c->second.hovered    = true;
+			update_cable(c->second);
+		}
+	}
+}
+
+guint
+ganv_canvas_get_collapsed_cable(GanvCanvas*      canvas,
+                                const GanvEdge*  edge,
+                                const GanvEdge** first)
+{
+	const GanvCanvasImpl* impl    = canvas->impl;
+	EdgeKey               modules;
+	if (!impl->aggregate_edges || !get_cable_key(edge, &modules)) {
+		return 0;
+	}
+
+	const GanvCanvasImpl::Cables::const_iterator c = impl->_cables.find(modules);
+	if (c == impl->_cables.end() || !cable_is_collapsed(impl, c->second)) {
+		return 0;
+	}
+
+	*first = c->second.edges.front();
+	return c->second.edges.size();
+}
+
+gboolean
+ganv_canvas_draw_bundle(GanvCanvas* canvas,
+                        GanvEdge*   edge,
+                        cairo_t*    cr,
+                        double      cx,
+                        double      cy,
+                        double      cw,
+                        double      ch)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+	if (edge->impl->draw_stamp == impl->draw_stamp) {
+		return TRUE;  // Already drawn with its bundle
+	}
+
+	EdgeKey modules;
+	if (!impl->bundle_edges || !ganv_edge_can_bundle(edge)
+	    || !get_cable_key(edge, &modules)) {
+		return FALSE;
+	}
+
+	const GanvCanvasImpl::Cables::const_iterator c = impl->_cables.find(modules);
+	if (c == impl->_cables.end() || c->second.edges.size() < 2) {
+		return FALSE;
+	}
+
+	/* Split the edges in the area being drawn, like the root group does, into
+	   those that share the stroke of the first inactive one, and the rest */
+	std::vector<GanvEdge*> plain;
+	std::vector<GanvEdge*> others;
+	for (GanvEdge* e : c->second.edges) {
+		const GanvItemPrivate* item = GANV_ITEM(e)->impl;
+		if (!(GANV_ITEM(e)->object.flags & GANV_ITEM_VISIBLE)
+		    || !ganv_edge_can_bundle(e)
+		    || item->x1 >= cx + cw || item->y1 >= cy + ch
+		    || item->x2 <= cx || item->y2 <= cy) {
+			continue;
+		}
+
+		if (!edge_is_active(e)
+		    && (plain.empty() || ganv_edge_same_stroke(plain.front(), e))) {
+			plain.push_back(e);
+		} else {
+			others.push_back(e);
+		}
+	}
+
+	if (plain.size() < 2) {
+		return FALSE;  // Nothing to batch, so every edge draws itself
+	}
+
+	for (GanvEdge* e : plain) {
+		e->impl->draw_stamp = impl->draw_stamp;
+	}
+	for (GanvEdge* e : others) {
+		e->impl->draw_stamp = impl->draw_stamp;
+	}
+
+	ganv_edge_draw_bundle(plain.data(), (guint)plain.size(),
+	                      others.data(), (guint)others.size(),
+	                      cr);
+	return TRUE;
+}
+
+void
+ganv_canvas_edge_activity_changed(GanvCanvas* canvas,
+                                  GanvEdge*   edge,
+                                  gboolean    active)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+	EdgeKey         modules;
+	if (!get_cable_key(edge, &modules)) {
+		return;
+	}
+
+	// Ignore edges that are not on the canvas (yet), they are counted on add
+	const GanvCanvasImpl::Edges::const_iterator e = impl->_edges.find(
+		EdgeKey(edge->impl->tail, edge->impl->head));
+	if (e == impl->_edges.end() || e->second != edge) {
+		return;
+	}
+
+	const GanvCanvasImpl::Cables::iterator c = impl->_cables.find(modules);
+	if (c != impl->_cables.end()) {
+		Cable&     cable = c->second;
+		const bool was   = cable_is_collapsed(impl, cable);
+		if (active) {
+			++cable.n_active;
+		} else if (cable.n_active > 0) {
+			--cable.n_active;
+		}
+		if (cable_is_collapsed(impl, cable) != was) {
+			update_cable(cable);
+		}
+	}
+}
+
 /* Convenience function to remove the idle handler of a canvas */
 static void
 remove_idle(GanvCanvas* canvas)
@@ -2989,6 +4660,24 @@ ganv_canvas_unrealize(GtkWidget* widget)
 	}
 }
 
+/* Screen changed handler for the canvas, text is measured for the new screen */
+static void
+ganv_canvas_screen_changed(GtkWidget* widget, GdkScreen* previous_screen)
+{
+	g_return_if_fail(GANV_IS_CANVAS(widget));
+
+	if (GTK_WIDGET_CLASS(canvas_parent_class)->screen_changed) {
+		(*GTK_WIDGET_CLASS(canvas_parent_class)->screen_changed)(
+			widget, previous_screen);
+	}
+
+	GanvCanvas* canvas = GANV_CANVAS(widget);
+	if (canvas->impl && gtk_widget_has_screen(widget)) {
+		canvas->impl->_layouts.match_screen(gtk_widget_get_screen(widget));
+		canvas->impl->invalidate_text();
+	}
+}
+
 /* Handles scrolling of the canvas.  Adjusts the scrolling and zooming offset to
  * keep as much as possible of the canvas scrolling region in view.
  */
@@ -3269,9 +4958,37 @@ ganv_canvas_set_need_repick(GanvCanvas* canvas)
 	canvas->impl->need_repick = TRUE;
 }
 
+void
+ganv_canvas_item_bounds_changed(GanvCanvas* canvas, GanvItem* item)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+	if (!impl || item->impl->parent != impl->root) {
+		return;
+	}
+
+	// Edges are indexed along their whole length, since they are picked there
+	const DRect rect = { item->impl->x1, item->impl->y1,
+	                     item->impl->x2, item->impl->y2 };
+	impl->_index.update(item, rect);
+	if (!GANV_IS_EDGE(item)) {
+		impl->_content.update(item, rect);
+		impl->content_changed = TRUE;
+	}
+}
+
 void
 ganv_canvas_forget_item(GanvCanvas* canvas, GanvItem* item)
 {
+	if (canvas->impl) {
+		canvas->impl->_index.remove(item);
+		canvas->impl->_content.remove(item);
+		canvas->impl->_select_rect_items.erase(item);
+	}
+
+	if (canvas->impl && item == canvas->impl->pick_item) {
+		canvas->impl->pick_item = NULL;
+	}
+
 	if (canvas->impl && item == canvas->impl->current_item) {
 		canvas->impl->current_item = NULL;
 		canvas->impl->need_repick  = TRUE;
@@ -3402,6 +5119,230 @@ ganv_canvas_get_zoom_offsets(GanvCanvas* canvas, int* x, int* y)
 	*y = canvas->impl->zoom_yofs;
 }
 
+/* Shrink @r, which contains (x, y), so that it does not overlap @s.
+ * Returns false if this is impossible.
+ */
+static gboolean
+exclude_rect(DRect* r, const DRect* s, double x, double y)
+{
+	if (s->x1 >= r->x2 || s->y1 >= r->y2 || s->x2 <= r->x1 || s->y2 <= r->y1) {
+		return TRUE;  // No overlap
+	}
+
+	// Cut away the side of s that leaves the largest area around the point
+	const double w    = r->x2 - r->x1;
+	const double h    = r->y2 - r->y1;
+	double       best = 0.0;
+	DRect        cut  = *r;
+	if (s->x2 < x && (r->x2 - s->x2) * h > best) {
+		best   = (r->x2 - s->x2) * h;
+		cut    = *r;
+		cut.x1 = s->x2;
+	}
+	if (s->x1 > x && (s->x1 - r->x1) * h > best) {
+		best   = (s->x1 - r->x1) * h;
+		cut    = *r;
+		cut.x2 = s->x1;
+	}
+	if (s->y2 < y && (r->y2 - s->y2) * w > best) {
+		best   = (r->y2 - s->y2) * w;
+		cut    = *r;
+		cut.y1 = s->y2;
+	}
+	if (s->y1 > y && (s->y1 - r->y1) * w > best) {
+		best   = (s->y1 - r->y1) * w;
+		cut    = *r;
+		cut.y2 = s->y1;
+	}
+
+	*r = cut;
+	return best > 0.0;
+}
+
+/* Shrink @r, which contains (x, y), so that it does not overlap anywhere
+ * @item may be picked.  Returns false if this is impossible.
+ */
+static gboolean
+exclude_pick_region(DRect* r, GanvItem* item, double x, double y)
+{
+	static const double pad = GANV_CLOSE_ENOUGH + 0.5;
+
+	if (!(item->object.flags & GANV_ITEM_VISIBLE) || GANV_IS_TEXT(item)) {
+		return TRUE;  // Text is never the actual item of a point query
+	}
+
+	if (!GANV_IS_EDGE(item)) {
+		const DRect s = { item->impl->x1 - pad, item->impl->y1 - pad,
+		                  item->impl->x2 + pad, item->impl->y2 + pad };
+		return exclude_rect(r, &s, x, y);
+	} else if (GANV_EDGE(item)->impl->hidden || GANV_EDGE(item)->impl->ghost) {
+		return TRUE;  // Never hit
+	}
+
+	// Edges are hit around their handle, or along their segment boxes
+	const GanvEdge*       edge  = GANV_EDGE(item);
+	const GanvEdgeCoords* c     = &edge->impl->coords;
+	const double          width = ganv_edge_get_line_width(edge);
+	const double          rad   = ganv_edge_get_handle_radius(edge) + width + pad;
+	const double          ww    = (width / 2.0) + pad;
+
+	double dx = 0.0;
+	double dy = 0.0;
+	ganv_item_i2w_offset(item, &dx, &dy);
+
+	const DRect handle = { c->handle_x + dx - rad, c->handle_y + dy - rad,
+	                       c->handle_x + dx + rad, c->handle_y + dy + rad };
+	if (!exclude_rect(r, &handle, x, y)) {
+		return FALSE;
+	}
+
+	GanvEdgePath path;
+	ganv_edge_get_path(edge, &path);
+	for (int b = 0; b * GANV_EDGE_SEGMENTS_PER_BOX < path.n_segments; ++b) {
+		const DRect s = { path.box_x1[b] + dx - ww, path.box_y1[b] + dy - ww,
+		                  path.box_x2[b] + dx + ww, path.box_y2[b] + dy + ww };
+		if (!exclude_rect(r, &s, x, y)) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* Get the stacking rank of a hit at item-relative (x, y) on a top level item.
+ *
+ * Edges hit along their curve rather than on their handle rank below
+ * everything else, so they never shadow the nodes they end on.
+ */
+static int
+pick_rank(GanvItem* item, double x, double y)
+{
+	if (!GANV_IS_EDGE(item)) {
+		return 1;
+	}
+
+	const GanvEdge* edge = GANV_EDGE(item);
+	const double    r    = ganv_edge_get_handle_radius(edge)
+		+ ganv_edge_get_line_width(edge) + GANV_CLOSE_ENOUGH;
+	const double dx = x - edge->impl->coords.handle_x;
+	const double dy = y - edge->impl->coords.handle_y;
+	return ((dx * dx) + (dy * dy) <= r * r) ? 1 : 0;
+}
+
+/* Find the item at world (x, y) like the point method of the root group, but
+ * only check the top level items near the point in the spatial index.
+ */
+static double
+pick_at(GanvCanvas* canvas, double x, double y, GanvItem** actual_item)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+	GanvItem*       root = impl->root;
+	const DRect     area = { x - GANV_CLOSE_ENOUGH, y - GANV_CLOSE_ENOUGH,
+	                         x + GANV_CLOSE_ENOUGH, y + GANV_CLOSE_ENOUGH };
+
+	GanvItem* top      = NULL;
+	int       top_rank = 0;
+	double    best     = 0.0;
+
+	*actual_item = NULL;
+	const auto hit = [&top, &top_rank, &best, &area, actual_item, root, x, y](
+		GanvItem* child) {
+		if (child->impl->x1 > area.x2 || child->impl->y1 > area.y2
+		    || child->impl->x2 < area.x1 || child->impl->y2 < area.y1
+		    || !(child->object.flags & GANV_ITEM_VISIBLE)
+		    || !GANV_ITEM_GET_CLASS(child)->point) {
+			return;  // Can not be hit here
+		}
+
+		const double cx         = x - root->impl->x - child->impl->x;
+		const double cy         = y - root->impl->y - child->impl->y;
+		GanvItem*    point_item = NULL;
+		const double dist       = GANV_ITEM_GET_CLASS(child)->point(
+			child, cx, cy, &point_item);
+		if (!point_item || (int)(dist + 0.5) > GANV_CLOSE_ENOUGH) {
+			return;  // Missed
+		}
+
+		const int rank = pick_rank(child, cx, cy);
+		if (!top || rank > top_rank
+		    || (rank == top_rank && child->impl->order > top->impl->order)) {
+			top          = child;
+			top_rank     = rank;
+			best         = dist;
+			*actual_item = point_item;
+		}
+	};
+
+	impl->_index.query(area, hit);
+	if (*actual_item) {
+		return best;
+	}
+
+	*actual_item = root;
+	return 0.0;
+}
+
+/* Calculate the pick cache for the item just picked at world (x, y).
+ *
+ * The cached rectangle is the part of the picked box around the pointer which
+ * is not overlapped by anything that could be picked instead, so while the
+ * pointer stays inside it and nothing changes, picking can be skipped.
+ */
+static void
+update_pick_cache(GanvCanvas* canvas, double x, double y)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+	GanvItem*       item = impl->new_current_item;
+
+	impl->pick_item = NULL;
+	if (!item || item == impl->root || !GANV_IS_BOX(item)) {
+		return;  // Only boxes are picked everywhere inside their bounds
+	}
+
+	DRect r = { item->impl->x1, item->impl->y1, item->impl->x2, item->impl->y2 };
+	if (x <= r.x1 || y <= r.y1 || x >= r.x2 || y >= r.y2) {
+		return;
+	}
+
+	// Find the top level item that contains the picked item
+	GanvItem* top = item;
+	if (top->impl->parent != impl->root) {
+		top = top->impl->parent;
+		if (!GANV_IS_MODULE(top) || top->impl->parent != impl->root) {
+			return;  // Nested in some other group, don't bother
+		}
+	}
+
+	// Exclude other ports on the same module, which may be picked instead
+	if (GANV_IS_MODULE(top)) {
+		GanvModule* module = GANV_MODULE(top);
+		for (guint i = 0; i < ganv_module_num_ports(module); ++i) {
+			GanvItem* port = GANV_ITEM(ganv_module_get_port(module, i));
+			if (port != item && !exclude_pick_region(&r, port, x, y)) {
+				return;
+			}
+		}
+	}
+
+	// Exclude top level items above this one, which may be picked instead
+	std::vector<GanvItem*> above;
+	impl->_index.query(r, [top, &above](GanvItem* other) {
+		if (other->impl->order > top->impl->order) {
+			above.push_back(other);
+		}
+	});
+
+	for (GanvItem* other : above) {
+		if (!exclude_pick_region(&r, other, x, y)) {
+			return;
+		}
+	}
+
+	impl->pick_item       = item;
+	impl->pick_generation = impl->generation;
+	impl->pick_rect       = r;
+}
+
 /* Re-picks the current item in the canvas, based on the event's coordinates.
  * Also emits enter/leave events for items as appropriate.
  */
@@ -3485,11 +5426,19 @@ pick_current_item(GanvCanvas* canvas, GdkEvent* event)
 
 		/* find the closest item */
 
-		if (canvas->impl->root->object.flags & GANV_ITEM_VISIBLE) {
-			GANV_ITEM_GET_CLASS(canvas->impl->root)->point(
-				canvas->impl->root,
-				x - canvas->impl->root->impl->x, y - canvas->impl->root->impl->y,
-				&canvas->impl->new_current_item);
+		const DRect* pr = &canvas->impl->pick_rect;
+		if (canvas->impl->pick_item
+		    && canvas->impl->pick_item == canvas->impl->current_item
+		    && canvas->impl->pick_generation == canvas->impl->generation
+		    && !canvas->impl->need_update
+		    && x > pr->x1 && y > pr->y1 && x < pr->x2 && y < pr->y2) {
+			/* still inside the cached hit region, nothing has changed */
+			canvas->impl->new_current_item = canvas->impl->current_item;
+		} else if (canvas->impl->root->object.flags & GANV_ITEM_VISIBLE) {
+			pick_at(canvas, x, y, &canvas->impl->new_current_item);
+			if (!canvas->impl->need_update) {
+				update_pick_cache(canvas, x, y);
+			}
 		} else {
 			canvas->impl->new_current_item = NULL;
 		}
@@ -3630,6 +5579,12 @@ ganv_canvas_motion(GtkWidget* widget, GdkEventMotion* event)
 
 	canvas->impl->state = event->state;
 	pick_current_item(canvas, (GdkEvent*)event);
+	if (canvas->impl->aggregate_edges) {
+		double x = 0.0;
+		double y = 0.0;
+		ganv_canvas_window_to_world(canvas, event->x, event->y, &x, &y);
+		hover_cable(canvas, x, y);
+	}
 	return ganv_canvas_emit_event(canvas, (GdkEvent*)event);
 }
 
@@ -3783,6 +5738,7 @@ ganv_canvas_paint_rect(GanvCanvas* canvas, gint x0, gint y0, gint x1, gint y1)
 		cairo_fill(cr);
 
 		// Draw root group
+		++canvas->impl->draw_stamp;
 		(*GANV_ITEM_GET_CLASS(canvas->impl->root)->draw)(
 			canvas->impl->root, cr,
 			wx1, wy1, ww, wh);
@@ -3857,16 +5813,65 @@ paint(GanvCanvas* canvas)
 	canvas->impl->redraw_y2 = 0;
 }
 
+/* Expand the canvas if necessary to contain all nodes */
+static void
+expand_to_content(GanvCanvas* canvas)
+{
+	GanvCanvasImpl* impl = canvas->impl;
+
+	impl->content_changed = FALSE;
+
+	DRect content;
+	if (impl->_content.get(&content)) {
+		const double pad = 10.0;
+		if (content.x2 + pad > impl->width || content.y2 + pad > impl->height) {
+			ganv_canvas_resize(canvas,
+			                   MAX(content.x2 + pad, impl->width),
+			                   MAX(content.y2 + pad, impl->height));
+		}
+	}
+}
+
+static void
+update_items(GanvCanvas* canvas)
+{
+	if (canvas->impl->batch_deferred_update) {
+		canvas->impl->batch_deferred_update = FALSE;
+		if (!canvas->impl->batch_depth) {
+			ganv_canvas_begin_batch(canvas);
+			update_items(canvas);
+			ganv_canvas_end_batch(canvas);
+			return;
+		}
+	}
+
+	canvas->impl->process_update_queue();
+	if (canvas->impl->root->object.flags & GANV_ITEM_NEED_UPDATE) {
+		// Update was requested on the root itself, update everything
+		ganv_item_invoke_update(canvas->impl->root, 0);
+		canvas->impl->process_update_queue();
+	}
+
+	canvas->impl->need_update = FALSE;
+	++canvas->impl->generation;
+
+	if (canvas->impl->content_changed) {
+		expand_to_content(canvas);
+	}
+}
+
 static void
 do_update(GanvCanvas* canvas)
 {
+	if (canvas->impl->batch_depth) {
+		return;  // Everything will be updated at the end of the batch
+	}
+
 	/* Cause the update if necessary */
 
 update_again:
 	if (canvas->impl->need_update) {
-		ganv_item_invoke_update(canvas->impl->root, 0);
-
-		canvas->impl->need_update = FALSE;
+		update_items(canvas);
 	}
 
 	/* Pick new current item */
@@ -4045,11 +6050,7 @@ ganv_canvas_get_item_at(GanvCanvas* canvas, double x, double y)
 	g_return_val_if_fail(GANV_IS_CANVAS(canvas), NULL);
 
 	GanvItem*    item = NULL;
-	const double dist = GANV_ITEM_GET_CLASS(canvas->impl->root)->point(
-		canvas->impl->root,
-		x - canvas->impl->root->impl->x,
-		y - canvas->impl->root->impl->y,
-		&item);
+	const double dist = pick_at(canvas, x, y, &item);
 	if ((int)(dist * canvas->impl->pixels_per_unit + 0.5) <= GANV_CLOSE_ENOUGH) {
 		return item;
 	} else {
@@ -4057,6 +6058,33 @@ ganv_canvas_get_item_at(GanvCanvas* canvas, double x, double y)
 	}
 }
 
+guint
+ganv_canvas_get_position_stamp(const GanvCanvas* canvas)
+{
+	return canvas->impl ? canvas->impl->position_stamp : 0;
+}
+
+void
+ganv_canvas_invalidate_offsets(GanvCanvas* canvas)
+{
+	if (canvas->impl) {
+		++canvas->impl->position_stamp;
+	}
+}
+
+void
+ganv_canvas_queue_update(GanvCanvas* canvas, GanvItem* item)
+{
+	g_object_ref(item);
+	if (GANV_IS_EDGE(item)) {
+		canvas->impl->_dirty_edges.push_back(item);
+	} else {
+		canvas->impl->_dirty_nodes.push_back(item);
+	}
+
+	ganv_canvas_request_update(canvas);
+}
+
 void
 ganv_canvas_request_update(GanvCanvas* canvas)
 {
@@ -4065,7 +6093,7 @@ ganv_canvas_request_update(GanvCanvas* canvas)
 	}
 
 	canvas->impl->need_update = TRUE;
-	if (GTK_WIDGET_MAPPED((GtkWidget*)canvas)) {
+	if (!canvas->impl->batch_depth && GTK_WIDGET_MAPPED((GtkWidget*)canvas)) {
 		add_idle(canvas);
 	}
 }
@@ -4109,6 +6137,25 @@ ganv_canvas_request_redraw_c(GanvCanvas* canvas,
 		return;
 	}
 
+	if (canvas->impl->batch_depth) {
+		// Redraw the bounds of everything requested at the end
+		IRect& r = canvas->impl->batch_redraw;
+		if (r.width > 0) {
+			const int rx2 = std::max(r.x + r.width, x2);
+			const int ry2 = std::max(r.y + r.height, y2);
+			r.x      = std::min(r.x, x1);
+			r.y      = std::min(r.y, y1);
+			r.width  = rx2 - r.x;
+			r.height = ry2 - r.y;
+		} else {
+			r.x      = x1;
+			r.y      = y1;
+			r.width  = x2 - x1;
+			r.height = y2 - y1;
+		}
+		return;
+	}
+
 	const IRect rect = { x1, y1, x2 - x1, y2 - y1 };
 
 	if (!rect_is_visible(canvas, &rect)) {
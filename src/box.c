@@ -362,16 +362,12 @@ ganv_box_is_within(const GanvNode* self,
                    double          x2,
                    double          y2)
 {
-	double bx1 = 0.0;
-	double by1 = 0.0;
-	double bx2 = 0.0;
-	double by2 = 0.0;
-	g_object_get(G_OBJECT(self),
-	             "x1", &bx1,
-	             "y1", &by1,
-	             "x2", &bx2,
-	             "y2", &by2,
-	             NULL);
+	const GanvBox* box = (const GanvBox*)self;
+
+	double bx1 = ganv_box_get_x1(box);
+	double by1 = ganv_box_get_y1(box);
+	double bx2 = ganv_box_get_x2(box);
+	double by2 = ganv_box_get_y2(box);
 
 	ganv_item_i2w_pair(GANV_ITEM(self), &bx1, &by1, &bx2, &by2);
 
@@ -381,6 +377,54 @@ ganv_box_is_within(const GanvNode* self,
 	           && by2 <= y2);
 }
 
+/* Request a redraw of only the strips along the border of a box */
+static void
+ganv_box_request_border_redraw(GanvBox* box)
+{
+	GanvItem*             item   = GANV_ITEM(box);
+	const GanvBoxPrivate* impl   = box->impl;
+	GanvCanvas*           canvas = item->impl->canvas;
+	if (!canvas) {
+		return;
+	}
+
+	// Strips must be wide enough to cover rounded or beveled corners
+	const double r = MAX(MAX(impl->radius_tl, impl->radius_tr),
+	                     MAX(impl->radius_br, impl->radius_bl));
+	const double w = (impl->coords.border_width / 2.0) + (r / 2.0) + 1.0;
+
+	double x1 = impl->coords.x1;
+	double y1 = impl->coords.y1;
+	double x2 = impl->coords.x2;
+	double y2 = impl->coords.y2;
+	ganv_item_i2w_pair(item, &x1, &y1, &x2, &y2);
+
+	for (int i = (impl->coords.stacked ? 1 : 0); i >= 0; --i) {
+		const double o = STACKED_OFFSET * i;
+
+		ganv_canvas_request_redraw_w(canvas,  // Top
+		                             x1 + o - w, y1 + o - w,
+		                             x2 + o + w, y1 + o + w);
+		ganv_canvas_request_redraw_w(canvas,  // Bottom
+		                             x1 + o - w, y2 + o - w,
+		                             x2 + o + w, y2 + o + w);
+		ganv_canvas_request_redraw_w(canvas,  // Left
+		                             x1 + o - w, y1 + o - w,
+		                             x1 + o + w, y2 + o + w);
+		ganv_canvas_request_redraw_w(canvas,  // Right
+		                             x2 + o - w, y1 + o - w,
+		                             x2 + o + w, y2 + o + w);
+	}
+}
+
+static void
+ganv_box_tick(GanvNode* node, double seconds)
+{
+	// Only the border dashes move, so skip updating and redraw the border
+	node->impl->dash_offset = seconds * 8.0;
+	ganv_box_request_border_redraw(GANV_BOX(node));
+}
+
 static void
 ganv_box_default_set_width(GanvBox* box, double width)
 {
@@ -504,6 +548,7 @@ ganv_box_class_init(GanvBoxClass* klass)
 	item_class->draw   = ganv_box_draw;
 
 	node_class->is_within = ganv_box_is_within;
+	node_class->tick      = ganv_box_tick;
 
 	klass->set_width  = ganv_box_default_set_width;
 	klass->set_height = ganv_box_default_set_height;
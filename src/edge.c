@@ -18,10 +18,13 @@
 #include "ganv-private.h"
 #include "gettext.h"
 
+#include <ganv/box.h>
 #include <ganv/canvas.h>
 #include <ganv/edge.h>
 #include <ganv/item.h>
+#include <ganv/module.h>
 #include <ganv/node.h>
+#include <ganv/port.h>
 #include <ganv/types.h>
 
 #include <cairo.h>
@@ -36,6 +39,13 @@
 #define ARROW_DEPTH   32
 #define ARROW_BREADTH 32
 
+// Size of the edge count drawn at the handle of an aggregated cable
+#define CABLE_BADGE_RADIUS    8.0
+#define CABLE_BADGE_FONT_SIZE 8.0
+
+// Maximum width added to the line of an aggregated cable
+#define CABLE_MAX_EXTRA_WIDTH 6.0
+
 // Uncomment to see control point path as straight lines
 //#define GANV_DEBUG_CURVES 1
 
@@ -82,10 +92,13 @@ ganv_edge_init(GanvEdge* edge)
 	impl->coords.curved        = FALSE;
 	impl->coords.arrowhead     = FALSE;
 
-	impl->old_coords  = impl->coords;
-	impl->dash_length = 0.0;
-	impl->dash_offset = 0.0;
-	impl->color       = 0;
+	impl->dash_length    = 0.0;
+	impl->dash_offset    = 0.0;
+	impl->color          = 0;
+	impl->hidden         = FALSE;
+	impl->cable_size     = 0;
+	impl->selected_index = G_MAXUINT;
+	impl->draw_stamp     = 0;
 }
 
 static void
@@ -106,6 +119,22 @@ ganv_edge_destroy(GtkObject* object)
 	}
 }
 
+static gboolean
+is_active(const GanvEdgePrivate* impl)
+{
+	return impl->selected || impl->highlighted;
+}
+
+/* Tell the canvas if an edge was selected or highlighted, or no longer is */
+static void
+notify_activity(GanvEdge* edge, gboolean was_active)
+{
+	GanvCanvas* canvas = GANV_ITEM(edge)->impl->canvas;
+	if (canvas && !edge->impl->ghost && is_active(edge->impl) != was_active) {
+		ganv_canvas_edge_activity_changed(canvas, edge, !was_active);
+	}
+}
+
 static void
 ganv_edge_set_property(GObject*      object,
                        guint         prop_id,
@@ -119,6 +148,7 @@ ganv_edge_set_property(GObject*      object,
 	GanvEdge*        edge   = GANV_EDGE(object);
 	GanvEdgePrivate* impl   = edge->impl;
 	GanvEdgeCoords*  coords = &impl->coords;
+	const gboolean   active = is_active(impl);
 
 	switch (prop_id) {
 		SET_CASE(WIDTH, double, coords->width)
@@ -152,6 +182,8 @@ ganv_edge_set_property(GObject*      object,
 		G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 		break;
 	}
+
+	notify_activity(edge, active);
 }
 
 static void
@@ -191,14 +223,22 @@ ganv_edge_request_redraw(GanvItem*             item,
                          const GanvEdgeCoords* coords)
 {
 	GanvCanvas* canvas = item->impl->canvas;
+	if (GANV_EDGE(item)->impl->cable_size > 0) {
+		// Cables are drawn larger than their coordinates, but fill the bounds
+		ganv_canvas_request_redraw_w(canvas,
+		                             item->impl->x1, item->impl->y1,
+		                             item->impl->x2, item->impl->y2);
+		return;
+	}
+
 	const double w = coords->width;
 	if (coords->curved) {
 		const double src_x  = coords->x1;
 		const double src_y  = coords->y1;
 		const double dst_x  = coords->x2;
 		const double dst_y  = coords->y2;
-		const double join_x = (src_x + dst_x) / 2.0;
-		const double join_y = (src_y + dst_y) / 2.0;
+		const double join_x = coords->handle_x;
+		const double join_y = coords->handle_y;
 		const double src_x1 = coords->cx1;
 		const double src_y1 = coords->cy1;
 		const double dst_x1 = coords->cx2;
@@ -250,26 +290,152 @@ ganv_edge_request_redraw(GanvItem*             item,
 	}
 }
 
+/* Get the area covered by everything drawn for coords */
+static void
+ganv_edge_redraw_bounds(const GanvEdgeCoords* coords,
+                        double* x1, double* y1,
+                        double* x2, double* y2)
+{
+	const double w = coords->width;
+	if (coords->curved) {
+		const double join_x = coords->handle_x;
+		const double join_y = coords->handle_y;
+
+		*x1 = MIN(MIN(coords->x1, coords->x2), MIN(coords->cx1, coords->cx2));
+		*y1 = MIN(MIN(coords->y1, coords->y2), MIN(coords->cy1, coords->cy2));
+		*x2 = MAX(MAX(coords->x1, coords->x2), MAX(coords->cx1, coords->cx2));
+		*y2 = MAX(MAX(coords->y1, coords->y2), MAX(coords->cy1, coords->cy2));
+		*x1 = MIN(*x1, join_x) - w;
+		*y1 = MIN(*y1, join_y) - w;
+		*x2 = MAX(*x2, join_x) + w;
+		*y2 = MAX(*y2, join_y) + w;
+	} else {
+		*x1 = MIN(coords->x1, coords->x2) - w;
+		*y1 = MIN(coords->y1, coords->y2) - w;
+		*x2 = MAX(coords->x1, coords->x2) + w;
+		*y2 = MAX(coords->y1, coords->y2) + w;
+	}
+
+	if (coords->handle_radius > 0.0) {
+		const double r = coords->handle_radius + w;
+		*x1 = MIN(*x1, coords->handle_x - r);
+		*y1 = MIN(*y1, coords->handle_y - r);
+		*x2 = MAX(*x2, coords->handle_x + r);
+		*y2 = MAX(*y2, coords->handle_y + r);
+	}
+
+	if (coords->arrowhead) {
+		*x1 = MIN(*x1, coords->x2 - ARROW_DEPTH);
+		*y1 = MIN(*y1, coords->y2 - ARROW_BREADTH);
+		*x2 = MAX(*x2, coords->x2 + ARROW_DEPTH);
+		*y2 = MAX(*y2, coords->y2 + ARROW_BREADTH);
+	}
+}
+
+/* Get the line width to draw an edge with, which is wider for cables */
+static double
+get_line_width(const GanvEdgePrivate* impl)
+{
+	return impl->coords.width + MIN((double)impl->cable_size,
+	                                CABLE_MAX_EXTRA_WIDTH);
+}
+
+double
+ganv_edge_get_line_width(const GanvEdge* edge)
+{
+	return get_line_width(edge->impl);
+}
+
+double
+ganv_edge_get_handle_radius(const GanvEdge* edge)
+{
+	return (edge->impl->cable_size > 0)
+		? CABLE_BADGE_RADIUS
+		: edge->impl->coords.handle_radius;
+}
+
 static void
 ganv_edge_bounds(GanvItem* item,
                  double* x1, double* y1,
                  double* x2, double* y2)
 {
-	GanvEdge*        edge   = GANV_EDGE(item);
-	GanvEdgePrivate* impl   = edge->impl;
-	GanvEdgeCoords*  coords = &impl->coords;
-	const double     w      = coords->width;
+	const GanvEdgePrivate* impl = GANV_EDGE(item)->impl;
+
+	ganv_edge_redraw_bounds(&impl->coords, x1, y1, x2, y2);
+	if (impl->cable_size > 0) {
+		const double pad = get_line_width(impl) - impl->coords.width;
+		const double r   = CABLE_BADGE_RADIUS;
+		*x1 = MIN(*x1 - pad, impl->coords.handle_x - r);
+		*y1 = MIN(*y1 - pad, impl->coords.handle_y - r);
+		*x2 = MAX(*x2 + pad, impl->coords.handle_x + r);
+		*y2 = MAX(*y2 + pad, impl->coords.handle_y + r);
+	}
+}
 
-	if (coords->curved) {
-		*x1 = MIN(coords->x1, MIN(coords->cx1, MIN(coords->x2, coords->cx2))) - w;
-		*y1 = MIN(coords->y1, MIN(coords->cy1, MIN(coords->y2, coords->cy2))) - w;
-		*x2 = MAX(coords->x1, MAX(coords->cx1, MAX(coords->x2, coords->cx2))) + w;
-		*y2 = MAX(coords->y1, MAX(coords->cy1, MAX(coords->y2, coords->cy2))) + w;
-	} else {
-		*x1 = MIN(impl->coords.x1, impl->coords.x2) - w;
-		*y1 = MIN(impl->coords.y1, impl->coords.y2) - w;
-		*x2 = MAX(impl->coords.x1, impl->coords.x2) + w;
-		*y2 = MAX(impl->coords.y1, impl->coords.y2) + w;
+/* Get the centre of the side of a port's module that its edges leave from */
+static gboolean
+get_bundle_anchor(const GanvNode* node,
+                  gboolean        tail,
+                  GanvDirection   dir,
+                  double*         x,
+                  double*         y)
+{
+	if (!GANV_IS_PORT(node)) {
+		return FALSE;
+	}
+
+	GanvModule*  module = ganv_port_get_module(GANV_PORT(node));
+	GanvItem*    item   = GANV_ITEM(module);
+	const double w      = ganv_box_get_width(GANV_BOX(module));
+	const double h      = ganv_box_get_height(GANV_BOX(module));
+
+	*x = 0.0;
+	*y = 0.0;
+	ganv_item_i2w(item, x, y);
+	switch (dir) {
+	case GANV_DIRECTION_RIGHT:
+		*x += tail ? w : 0.0;
+		*y += h / 2.0;
+		break;
+	case GANV_DIRECTION_DOWN:
+		*x += w / 2.0;
+		*y += tail ? h : 0.0;
+		break;
+	}
+
+	return TRUE;
+}
+
+/* Route an edge between ports through points shared by all edges between the
+   same two modules, so they are drawn as a bundle. */
+static void
+bundle_coords(const GanvEdge* edge, GanvDirection dir, GanvEdgeCoords* coords)
+{
+	double tx = 0.0;
+	double ty = 0.0;
+	double hx = 0.0;
+	double hy = 0.0;
+	if (!get_bundle_anchor(edge->impl->tail, TRUE, dir, &tx, &ty)
+	    || !get_bundle_anchor(edge->impl->head, FALSE, dir, &hx, &hy)
+	    || (tx == hx && ty == hy)) {
+		return;
+	}
+
+	coords->handle_x = (tx + hx) / 2.0;
+	coords->handle_y = (ty + hy) / 2.0;
+	switch (dir) {
+	case GANV_DIRECTION_RIGHT:
+		coords->cx1 = tx + (fabs(hx - tx) / 4.0);
+		coords->cy1 = ty;
+		coords->cx2 = hx - (fabs(hx - tx) / 4.0);
+		coords->cy2 = hy;
+		break;
+	case GANV_DIRECTION_DOWN:
+		coords->cx1 = tx;
+		coords->cy1 = ty + (fabs(hy - ty) / 4.0);
+		coords->cx2 = hx;
+		coords->cy2 = hy - (fabs(hy - ty) / 4.0);
+		break;
 	}
 }
 
@@ -298,22 +464,118 @@ ganv_edge_get_coords(const GanvEdge* edge, GanvEdgeCoords* coords)
 	coords->cy1 = coords->y1 + (coords->cy1 * (abs_dy / 4.0));
 	coords->cx2 = coords->x2 + (coords->cx2 * (abs_dx / 4.0));
 	coords->cy2 = coords->y2 + (coords->cy2 * (abs_dy / 4.0));
+
+	GanvCanvas* canvas = GANV_ITEM(edge)->impl->canvas;
+	if (impl->coords.curved && canvas && ganv_canvas_get_bundle_edges(canvas)) {
+		bundle_coords(edge, ganv_canvas_get_direction(canvas), coords);
+	}
 }
 
 static void
-ganv_edge_update(GanvItem* item, int flags)
+path_add_curve(GanvEdgePath* path,
+               double x0, double y0,
+               double x1, double y1,
+               double x2, double y2,
+               double x3, double y3)
 {
-	GanvEdge*        edge = GANV_EDGE(item);
-	GanvEdgePrivate* impl = edge->impl;
+	static const int n = GANV_EDGE_N_SEGMENTS / 2;
+
+	for (int i = 1; i <= n; ++i) {
+		const double t  = (double)i / n;
+		const double mt = 1.0 - t;
+		const double a  = mt * mt * mt;
+		const double b  = 3.0 * mt * mt * t;
+		const double c  = 3.0 * mt * t * t;
+		const double d  = t * t * t;
+
+		++path->n_segments;
+		path->x[path->n_segments] = (float)((a * x0) + (b * x1) + (c * x2) + (d * x3));
+		path->y[path->n_segments] = (float)((a * y0) + (b * y1) + (c * y2) + (d * y3));
+	}
+}
 
-	// Request redraw of old location
-	ganv_edge_request_redraw(item, &impl->old_coords);
+void
+ganv_edge_get_path(const GanvEdge* edge, GanvEdgePath* path)
+{
+	const GanvEdgeCoords* coords = &edge->impl->coords;
+
+	path->x[0]       = (float)coords->x1;
+	path->y[0]       = (float)coords->y1;
+	path->n_segments = 0;
+
+	if (coords->curved) {
+		// The same two curves joined at the handle as drawn
+		const double join_x = coords->handle_x;
+		const double join_y = coords->handle_y;
+
+		path_add_curve(path,
+		               coords->x1, coords->y1,
+		               coords->cx1, coords->cy1,
+		               (join_x + coords->cx1) / 2.0, (join_y + coords->cy1) / 2.0,
+		               join_x, join_y);
+		path_add_curve(path,
+		               join_x, join_y,
+		               (join_x + coords->cx2) / 2.0, (join_y + coords->cy2) / 2.0,
+		               coords->cx2, coords->cy2,
+		               coords->x2, coords->y2);
+	} else {
+		path->n_segments = 1;
+		path->x[1]       = (float)coords->x2;
+		path->y[1]       = (float)coords->y2;
+	}
+
+	for (int b = 0; b * GANV_EDGE_SEGMENTS_PER_BOX < path->n_segments; ++b) {
+		const int first = b * GANV_EDGE_SEGMENTS_PER_BOX;
+		const int last  = MIN(first + GANV_EDGE_SEGMENTS_PER_BOX,
+		                      path->n_segments);
+
+		path->box_x1[b] = path->box_x2[b] = path->x[first];
+		path->box_y1[b] = path->box_y2[b] = path->y[first];
+		for (int i = first + 1; i <= last; ++i) {
+			path->box_x1[b] = MIN(path->box_x1[b], path->x[i]);
+			path->box_y1[b] = MIN(path->box_y1[b], path->y[i]);
+			path->box_x2[b] = MAX(path->box_x2[b], path->x[i]);
+			path->box_y2[b] = MAX(path->box_y2[b], path->y[i]);
+		}
+	}
+}
+
+static void
+ganv_edge_update(GanvItem* item, int flags)
+{
+	GanvEdge*        edge   = GANV_EDGE(item);
+	GanvEdgePrivate* impl   = edge->impl;
+	GanvCanvas*      canvas = item->impl->canvas;
+
+	// The previous bounding box covers everything drawn at the old location
+	const double ox1 = item->impl->x1;
+	const double oy1 = item->impl->y1;
+	const double ox2 = item->impl->x2;
+	const double oy2 = item->impl->y2;
+
+	// Check if this edge is collapsed into a cable with others
+	const GanvEdge* first = NULL;
+	const guint     n     = (canvas && !impl->ghost)
+		? ganv_canvas_get_collapsed_cable(canvas, edge, &first)
+		: 0;
+
+	impl->hidden     = (n > 0 && first != edge);
+	impl->cable_size = (n > 0 && first == edge) ? n : 0;
+	if (impl->hidden) {
+		// Drawn by the first edge in the cable, so only erase the old location
+		ganv_canvas_request_redraw_w(canvas, ox1, oy1, ox2, oy2);
+		item->impl->x1 = item->impl->x2 = impl->coords.handle_x;
+		item->impl->y1 = item->impl->y2 = impl->coords.handle_y;
+		parent_class->update(item, flags);
+		return;
+	}
 
 	// Calculate new coordinates from tail and head
 	ganv_edge_get_coords(edge, &impl->coords);
-
-	// Update old coordinates
-	impl->old_coords = impl->coords;
+	if (impl->cable_size > 0 && impl->coords.curved
+	    && !ganv_canvas_get_bundle_edges(canvas)) {
+		bundle_coords(edge, ganv_canvas_get_direction(canvas), &impl->coords);
+	}
 
 	// Get bounding box
 	double x1 = 0.0;
@@ -337,31 +599,26 @@ ganv_edge_update(GanvItem* item, int flags)
 	item->impl->y2 = y2;
 	ganv_item_i2w_pair(item, &item->impl->x1, &item->impl->y1, &item->impl->x2, &item->impl->y2);
 
-	// Request redraw of new location
-	ganv_edge_request_redraw(item, &impl->coords);
+	// Request redraw of old and new location, in one go if they overlap
+	if (ox1 <= item->impl->x2 && item->impl->x1 <= ox2
+	    && oy1 <= item->impl->y2 && item->impl->y1 <= oy2) {
+		ganv_canvas_request_redraw_w(item->impl->canvas,
+		                             MIN(ox1, item->impl->x1),
+		                             MIN(oy1, item->impl->y1),
+		                             MAX(ox2, item->impl->x2),
+		                             MAX(oy2, item->impl->y2));
+	} else {
+		ganv_canvas_request_redraw_w(item->impl->canvas, ox1, oy1, ox2, oy2);
+		ganv_edge_request_redraw(item, &impl->coords);
+	}
 
 	parent_class->update(item, flags);
 }
 
+/* Set the colour, width, and dash of the line of an edge */
 static void
-ganv_edge_draw(GanvItem* item,
-               cairo_t* cr, double cx, double cy, double cw, double ch)
+set_stroke(cairo_t* cr, const GanvEdgePrivate* impl)
 {
-	(void)cx;
-	(void)cy;
-	(void)cw;
-	(void)ch;
-
-	GanvEdge*        edge = GANV_EDGE(item);
-	GanvEdgePrivate* impl = edge->impl;
-
-	double src_x = impl->coords.x1;
-	double src_y = impl->coords.y1;
-	double dst_x = impl->coords.x2;
-	double dst_y = impl->coords.y2;
-	double dx    = src_x - dst_x;
-	double dy    = src_y - dst_y;
-
 	double r = 0.0;
 	double g = 0.0;
 	double b = 0.0;
@@ -373,8 +630,7 @@ ganv_edge_draw(GanvItem* item,
 	}
 	cairo_set_source_rgba(cr, r, g, b, a);
 
-	cairo_set_line_width(cr, impl->coords.width);
-	cairo_move_to(cr, src_x, src_y);
+	cairo_set_line_width(cr, get_line_width(impl));
 
 	const double dash_length = (impl->selected ? 4.0 : impl->dash_length);
 	if (dash_length > 0.0) {
@@ -383,32 +639,61 @@ ganv_edge_draw(GanvItem* item,
 	} else {
 		cairo_set_dash(cr, &dash_length, 0, 0);
 	}
+}
 
-	const double join_x = (src_x + dst_x) / 2.0;
-	const double join_y = (src_y + dst_y) / 2.0;
+/* Add a curved line as 2 curves which join at the handle to the path */
+static void
+add_curve(cairo_t* cr, const GanvEdgeCoords* coords)
+{
+	const double join_x = coords->handle_x;
+	const double join_y = coords->handle_y;
+
+	// Path 1 (x1, y1) -> (join_x, join_y)
+	const double src_x2 = (join_x + coords->cx1) / 2.0;
+	const double src_y2 = (join_y + coords->cy1) / 2.0;
+
+	// Path 2, (join_x, join_y) -> (x2, y2)
+	const double dst_x2 = (join_x + coords->cx2) / 2.0;
+	const double dst_y2 = (join_y + coords->cy2) / 2.0;
+
+	cairo_move_to(cr, coords->x1, coords->y1);
+	cairo_curve_to(cr,
+	               coords->cx1, coords->cy1, src_x2, src_y2, join_x, join_y);
+	cairo_curve_to(cr,
+	               dst_x2, dst_y2, coords->cx2, coords->cy2, coords->x2, coords->y2);
+}
 
-	if (impl->coords.curved) {
-		// Curved line as 2 paths which join at the middle point
-
-		// Path 1 (src_x, src_y) -> (join_x, join_y)
-		// Control point 1
-		const double src_x1 = impl->coords.cx1;
-		const double src_y1 = impl->coords.cy1;
-		// Control point 2
-		const double src_x2 = (join_x + src_x1) / 2.0;
-		const double src_y2 = (join_y + src_y1) / 2.0;
-
-		// Path 2, (join_x, join_y) -> (dst_x, dst_y)
-		// Control point 1
-		const double dst_x1 = impl->coords.cx2;
-		const double dst_y1 = impl->coords.cy2;
-		// Control point 2
-		const double dst_x2 = (join_x + dst_x1) / 2.0;
-		const double dst_y2 = (join_y + dst_y1) / 2.0;
+/* Add the arrowhead at the end of a curved line to the path */
+static void
+add_curve_arrowhead(cairo_t* cr, const GanvEdgeCoords* coords)
+{
+	cairo_move_to(cr, coords->x2 - 12, coords->y2 - 4);
+	cairo_line_to(cr, coords->x2, coords->y2);
+	cairo_line_to(cr, coords->x2 - 12, coords->y2 + 4);
+	cairo_close_path(cr);
+}
 
-		cairo_move_to(cr, src_x, src_y);
-		cairo_curve_to(cr, src_x1, src_y1, src_x2, src_y2, join_x, join_y);
-		cairo_curve_to(cr, dst_x2, dst_y2, dst_x1, dst_y1, dst_x, dst_y);
+static void
+draw_edge(GanvItem* item, cairo_t* cr)
+{
+	GanvEdge*        edge = GANV_EDGE(item);
+	GanvEdgePrivate* impl = edge->impl;
+
+	double src_x = impl->coords.x1;
+	double src_y = impl->coords.y1;
+	double dst_x = impl->coords.x2;
+	double dst_y = impl->coords.y2;
+	double dx    = src_x - dst_x;
+	double dy    = src_y - dst_y;
+
+	set_stroke(cr, impl);
+	cairo_move_to(cr, src_x, src_y);
+
+	const double join_x = impl->coords.handle_x;
+	const double join_y = impl->coords.handle_y;
+
+	if (impl->coords.curved) {
+		add_curve(cr, &impl->coords);
 
 #ifdef GANV_DEBUG_CURVES
 		cairo_stroke(cr);
@@ -416,19 +701,23 @@ ganv_edge_draw(GanvItem* item,
 		cairo_set_source_rgba(cr, 1.0, 0, 0, 0.5);
 
 		cairo_move_to(cr, src_x, src_y);
-		cairo_line_to(cr, src_x1, src_y1);
+		cairo_line_to(cr, impl->coords.cx1, impl->coords.cy1);
 		cairo_stroke(cr);
 
 		cairo_move_to(cr, join_x, join_y);
-		cairo_line_to(cr, src_x2, src_y2);
+		cairo_line_to(cr,
+		              (join_x + impl->coords.cx1) / 2.0,
+		              (join_y + impl->coords.cy1) / 2.0);
 		cairo_stroke(cr);
 
 		cairo_move_to(cr, join_x, join_y);
-		cairo_line_to(cr, dst_x2, dst_y2);
+		cairo_line_to(cr,
+		              (join_x + impl->coords.cx2) / 2.0,
+		              (join_y + impl->coords.cy2) / 2.0);
 		cairo_stroke(cr);
 
 		cairo_move_to(cr, dst_x, dst_y);
-		cairo_line_to(cr, dst_x1, dst_y1);
+		cairo_line_to(cr, impl->coords.cx2, impl->coords.cy2);
 		cairo_stroke(cr);
 
 #ifdef GANV_DEBUG_BOUNDS
@@ -444,10 +733,7 @@ ganv_edge_draw(GanvItem* item,
 
 		cairo_stroke(cr);
 		if (impl->coords.arrowhead) {
-			cairo_move_to(cr, dst_x - 12, dst_y - 4);
-			cairo_line_to(cr, dst_x, dst_y);
-			cairo_line_to(cr, dst_x - 12, dst_y + 4);
-			cairo_close_path(cr);
+			add_curve_arrowhead(cr, &impl->coords);
 			cairo_stroke_preserve(cr);
 			cairo_fill(cr);
 		}
@@ -478,33 +764,198 @@ ganv_edge_draw(GanvItem* item,
 		}
 	}
 
-	if (!ganv_canvas_exporting(item->impl->canvas) &&
-	    impl->coords.handle_radius > 0.0) {
+	if (impl->cable_size > 0) {
+		// Number of edges in the cable, in a circle at the handle
+		char count[16];
+		g_snprintf(count, sizeof(count), "%u", impl->cable_size);
+
+		cairo_new_path(cr);
+		cairo_arc(cr, join_x, join_y, CABLE_BADGE_RADIUS, 0, 2 * G_PI);
+		cairo_fill(cr);
+
+		GanvCanvas*  canvas = item->impl->canvas;
+		int          width  = 0;
+		int          height = 0;
+		PangoLayout* layout = ganv_canvas_get_layout(
+			canvas, count, CABLE_BADGE_FONT_SIZE, &width, &height);
+
+		cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 1.0);
+		ganv_canvas_draw_layout(canvas, cr, layout,
+		                        join_x - (width / 2.0),
+		                        join_y - (height / 2.0));
+		ganv_canvas_release_layout(canvas, layout);
+	} else if (!ganv_canvas_exporting(item->impl->canvas) &&
+	           impl->coords.handle_radius > 0.0) {
 		cairo_move_to(cr, join_x, join_y);
 		cairo_arc(cr, join_x, join_y, impl->coords.handle_radius, 0, 2 * G_PI);
 		cairo_fill(cr);
 	}
 }
 
+/* Draw edges that share a stroke with one path, then draw the rest of their
+   bundle over them one by one. */
+void
+ganv_edge_draw_bundle(GanvEdge** edges,
+                      guint      n_edges,
+                      GanvEdge** others,
+                      guint      n_others,
+                      cairo_t*   cr)
+{
+	if (n_edges > 0) {
+		set_stroke(cr, edges[0]->impl);
+
+		cairo_new_path(cr);
+		for (guint i = 0; i < n_edges; ++i) {
+			add_curve(cr, &edges[i]->impl->coords);
+		}
+		cairo_stroke(cr);
+
+		gboolean arrowheads = FALSE;
+		for (guint i = 0; i < n_edges; ++i) {
+			if (edges[i]->impl->coords.arrowhead) {
+				add_curve_arrowhead(cr, &edges[i]->impl->coords);
+				arrowheads = TRUE;
+			}
+		}
+		if (arrowheads) {
+			cairo_stroke_preserve(cr);
+			cairo_fill(cr);
+		}
+
+		if (!ganv_canvas_exporting(GANV_ITEM(edges[0])->impl->canvas)) {
+			for (guint i = 0; i < n_edges; ++i) {
+				const GanvEdgeCoords* coords = &edges[i]->impl->coords;
+				if (coords->handle_radius > 0.0) {
+					cairo_move_to(cr, coords->handle_x, coords->handle_y);
+					cairo_arc(cr, coords->handle_x, coords->handle_y,
+					          coords->handle_radius, 0, 2 * G_PI);
+				}
+			}
+			cairo_fill(cr);
+		}
+	}
+
+	for (guint i = 0; i < n_others; ++i) {
+		draw_edge(GANV_ITEM(others[i]), cr);
+	}
+}
+
+gboolean
+ganv_edge_can_bundle(const GanvEdge* edge)
+{
+	const GanvEdgePrivate* impl = edge->impl;
+	return impl->coords.curved && !impl->hidden && !impl->ghost
+		&& !impl->cable_size;
+}
+
+gboolean
+ganv_edge_same_stroke(const GanvEdge* a, const GanvEdge* b)
+{
+	const GanvEdgePrivate* ai = a->impl;
+	const GanvEdgePrivate* bi = b->impl;
+	return ai->color == bi->color
+		&& ai->highlighted == bi->highlighted
+		&& ai->selected == bi->selected
+		&& get_line_width(ai) == get_line_width(bi)
+		&& ai->dash_length == bi->dash_length
+		&& ai->dash_offset == bi->dash_offset;
+}
+
+static void
+ganv_edge_draw(GanvItem* item,
+               cairo_t* cr, double cx, double cy, double cw, double ch)
+{
+	GanvEdge* edge = GANV_EDGE(item);
+	if (edge->impl->hidden || ganv_canvas_draw_bundle(
+		    item->impl->canvas, edge, cr, cx, cy, cw, ch)) {
+		return;
+	}
+
+	draw_edge(item, cr);
+}
+
+static double
+rect_distance(double x, double y,
+              double x1, double y1, double x2, double y2)
+{
+	const double dx = (x < x1) ? (x1 - x) : (x > x2) ? (x - x2) : 0.0;
+	const double dy = (y < y1) ? (y1 - y) : (y > y2) ? (y - y2) : 0.0;
+
+	return sqrt((dx * dx) + (dy * dy));
+}
+
+static double
+segment_distance(double x, double y,
+                 double x1, double y1, double x2, double y2)
+{
+	const double dx  = x2 - x1;
+	const double dy  = y2 - y1;
+	const double len = (dx * dx) + (dy * dy);
+
+	double t = 0.0;
+	if (len > 0.0) {
+		t = (((x - x1) * dx) + ((y - y1) * dy)) / len;
+		t = MAX(0.0, MIN(1.0, t));
+	}
+
+	const double px = x - (x1 + (t * dx));
+	const double py = y - (y1 + (t * dy));
+	return sqrt((px * px) + (py * py));
+}
+
 static double
 ganv_edge_point(GanvItem* item, double x, double y, GanvItem** actual_item)
 {
-	const GanvEdge*       edge = GANV_EDGE(item);
+	const GanvEdge*       edge   = GANV_EDGE(item);
 	const GanvEdgeCoords* coords = &edge->impl->coords;
+	const double          width  = get_line_width(edge->impl);
+	const double          half_w = width / 2.0;
+	const double          radius = ganv_edge_get_handle_radius(edge);
+
+	*actual_item = item;
+
+	if (edge->impl->hidden || edge->impl->ghost) {
+		// Not drawn, or only drawn while connecting, so can not be hit
+		return G_MAXDOUBLE;
+	}
 
 	const double dx = fabs(x - coords->handle_x);
 	const double dy = fabs(y - coords->handle_y);
 	const double d  = sqrt((dx * dx) + (dy * dy));
 
-	*actual_item = item;
-
-	if (d <= coords->handle_radius) {
+	if (d <= radius) {
 		// Point is inside the handle
 		return 0.0;
-	} else {
-		// Distance from the edge of the handle
-		return d - (coords->handle_radius + coords->width);
 	}
+
+	// Distance from the edge of the handle
+	double best = d - (radius + width);
+
+	GanvEdgePath path;
+	ganv_edge_get_path(edge, &path);
+
+	// Distance from the line, only checking segments in boxes that are closer
+	for (int b = 0; b * GANV_EDGE_SEGMENTS_PER_BOX < path.n_segments; ++b) {
+		const double box_d = rect_distance(x, y,
+		                                   path.box_x1[b], path.box_y1[b],
+		                                   path.box_x2[b], path.box_y2[b]);
+		if (box_d - half_w >= best) {
+			continue;
+		}
+
+		const int first = b * GANV_EDGE_SEGMENTS_PER_BOX;
+		const int last  = MIN(first + GANV_EDGE_SEGMENTS_PER_BOX,
+		                      path.n_segments);
+		for (int i = first; i < last; ++i) {
+			const double seg_d = segment_distance(x, y,
+			                                      path.x[i], path.y[i],
+			                                      path.x[i + 1], path.y[i + 1]);
+
+			best = MIN(best, MAX(0.0, seg_d - half_w));
+		}
+	}
+
+	return best;
 }
 
 gboolean
@@ -754,19 +1205,34 @@ ganv_edge_unhighlight(GanvEdge* edge)
 	ganv_edge_set_highlighted(edge, FALSE);
 }
 
+gboolean
+ganv_edge_get_selected(const GanvEdge* edge)
+{
+	return edge->impl->selected;
+}
+
+gboolean
+ganv_edge_get_highlighted(const GanvEdge* edge)
+{
+	return edge->impl->highlighted;
+}
+
 void
 ganv_edge_set_highlighted(GanvEdge* edge, gboolean highlighted)
 {
+	const gboolean active = is_active(edge->impl);
+
 	edge->impl->highlighted = highlighted;
 	ganv_edge_request_redraw(GANV_ITEM(edge), &edge->impl->coords);
+	notify_activity(edge, active);
 }
 
 void
 ganv_edge_tick(GanvEdge* edge, double seconds)
 {
-	ganv_item_set(GANV_ITEM(edge),
-	              "dash-offset", seconds * 8.0,
-	              NULL);
+	// Only the dashes move, so redraw along the edge without updating it
+	edge->impl->dash_offset = seconds * 8.0;
+	ganv_edge_request_redraw(GANV_ITEM(edge), &edge->impl->coords);
 }
 
 void
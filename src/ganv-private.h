@@ -21,6 +21,7 @@ extern "C" {
 #endif
 
 #include <ganv/canvas.h>
+#include <ganv/group.h>
 #include <ganv/item.h>
 #include <ganv/text.h>
 #include <ganv/types.h>
@@ -78,18 +79,42 @@ typedef struct {
 	gboolean arrowhead;
 } GanvEdgeCoords;
 
+/* Number of line segments a curved edge is flattened to for hit testing */
+#define GANV_EDGE_N_SEGMENTS 16
+
+/* Number of consecutive segments covered by each box in the segment index */
+#define GANV_EDGE_SEGMENTS_PER_BOX 4
+
+#define GANV_EDGE_N_BOXES (GANV_EDGE_N_SEGMENTS / GANV_EDGE_SEGMENTS_PER_BOX)
+
+/* Flattened edge path, with bounding boxes for runs of segments.  This is
+   only calculated on the stack for hit testing, so single precision is
+   plenty. */
+typedef struct {
+	float x[GANV_EDGE_N_SEGMENTS + 1];
+	float y[GANV_EDGE_N_SEGMENTS + 1];
+	float box_x1[GANV_EDGE_N_BOXES];
+	float box_y1[GANV_EDGE_N_BOXES];
+	float box_x2[GANV_EDGE_N_BOXES];
+	float box_y2[GANV_EDGE_N_BOXES];
+	int   n_segments;
+} GanvEdgePath;
+
 struct _GanvEdgePrivate
 {
 	GanvNode*       tail;
 	GanvNode*       head;
 	GanvEdgeCoords  coords;
-	GanvEdgeCoords  old_coords;
 	double          dash_length;
 	double          dash_offset;
 	guint           color;
 	gboolean        selected;
 	gboolean        highlighted;
 	gboolean        ghost;
+	gboolean        hidden;
+	guint           cable_size;
+	guint           selected_index;
+	guint           draw_stamp;
 };
 
 /* Module */
@@ -97,6 +122,9 @@ struct _GanvEdgePrivate
 struct _GanvModulePrivate
 {
 	GPtrArray* ports;
+	guint      n_holes;
+	guint      n_inputs;
+	guint      n_outputs;
 	GanvItem*  embed_item;
 	int        embed_width;
 	int        embed_height;
@@ -131,6 +159,9 @@ struct _GanvNodePrivate {
 	gboolean          show_label;
 	gboolean          grabbed;
 	gboolean          must_resize;
+	guint             canvas_index;
+	guint             selected_index;
+	guint             stale_index;
 #ifdef GANV_FDGL
 	Vector            force;
 	Vector            vel;
@@ -160,6 +191,7 @@ struct _GanvWidgetPrivate {
 struct _GanvGroupPrivate {
 	GList* item_list;
 	GList* item_list_end;
+	guint  n_added;
 };
 
 /* Item */
@@ -176,12 +208,24 @@ struct _GanvItemPrivate {
 	/* Layer (z order), higher values are on top */
 	guint layer;
 
+	/* Order this item was added to its parent in, later items are on top */
+	guint order;
+
 	/* Position in parent-relative coordinates. */
 	double x, y;
 
 	/* Bounding box for this item (in world coordinates) */
 	double x1, y1, x2, y2;
 
+	/* Cached offset from item-relative to top level ancestor coordinates */
+	double offset_x, offset_y;
+
+	/* Top level ancestor the cached offset is relative to */
+	GanvItem* offset_top;
+
+	/* Value of the canvas position stamp when the offset was calculated */
+	guint offset_stamp;
+
 	/* True if parent manages this item (don't call add/remove) */
 	gboolean managed;
 };
@@ -234,6 +278,7 @@ struct _GanvPortPrivate {
 	GanvText*        value_label;
 	gboolean         is_input;
 	gboolean         is_controllable;
+	guint            module_index;
 };
 
 /* Text */
@@ -304,6 +349,31 @@ void
 ganv_canvas_disconnect_edge(GanvCanvas* canvas,
                             GanvEdge*   edge);
 
+/* Return the number of edges in the collapsed cable that contains edge, and
+   set first to the edge that draws it, or return 0 if edge is drawn alone */
+guint
+ganv_canvas_get_collapsed_cable(GanvCanvas*      canvas,
+                                const GanvEdge*  edge,
+                                const GanvEdge** first);
+
+/* Notify the canvas that an edge has been selected or highlighted, or no
+   longer is, which expands or collapses its cable */
+void
+ganv_canvas_edge_activity_changed(GanvCanvas* canvas,
+                                  GanvEdge*   edge,
+                                  gboolean    active);
+
+/* Draw an edge with the rest of its bundle in the area being drawn, if edges
+   are bundled.  Return false if the edge must be drawn alone. */
+gboolean
+ganv_canvas_draw_bundle(GanvCanvas* canvas,
+                        GanvEdge*   edge,
+                        cairo_t*    cr,
+                        double      cx,
+                        double      cy,
+                        double      cw,
+                        double      ch);
+
 gboolean
 ganv_canvas_port_event(GanvCanvas* canvas,
                        GanvPort*   port,
@@ -312,18 +382,94 @@ ganv_canvas_port_event(GanvCanvas* canvas,
 void
 ganv_canvas_contents_changed(GanvCanvas* canvas);
 
+/* Get a new reference to a layout of text that is shared with all labels
+   with the same text and font size, and its size in pixels.  The layout must
+   not be modified, and must be released with ganv_canvas_release_layout(). */
+PangoLayout*
+ganv_canvas_get_layout(GanvCanvas* canvas,
+                       const char* text,
+                       double      points,
+                       int*        width,
+                       int*        height);
+
+void
+ganv_canvas_release_layout(GanvCanvas* canvas, PangoLayout* layout);
+
+/* Draw a layout from ganv_canvas_get_layout() in the current source colour,
+   from a cached rendering at the current scale if possible. */
+void
+ganv_canvas_draw_layout(GanvCanvas*  canvas,
+                        cairo_t*     cr,
+                        PangoLayout* layout,
+                        double       x,
+                        double       y);
+
 void
 ganv_item_i2w_offset(GanvItem* item, double* px, double* py);
 
+/* Get the size of text in pixels, laying it out first if necessary */
+void
+ganv_text_get_size(GanvText* text, double* width, double* height);
+
+/* Invalidate cached world offsets of everything in an item, must be called
+   when it is moved or reparented */
+void
+ganv_item_invalidate_offsets(GanvItem* item);
+
+/* Get a counter that is incremented whenever an item below the top level of
+   the canvas moves */
+guint
+ganv_canvas_get_position_stamp(const GanvCanvas* canvas);
+
+void
+ganv_canvas_invalidate_offsets(GanvCanvas* canvas);
+
 void
 ganv_item_i2w_pair(GanvItem* item, double* x1, double* y1, double* x2, double* y2);
 
 void
 ganv_item_invoke_update(GanvItem* item, int flags);
 
+/* Get the width an edge is stroked with, which is wider for cables */
+double
+ganv_edge_get_line_width(const GanvEdge* edge);
+
+/* Get the radius of the handle of an edge, or of its cable badge */
+double
+ganv_edge_get_handle_radius(const GanvEdge* edge);
+
+/* Flatten the curve of an edge into line segments for hit testing */
+void
+ganv_edge_get_path(const GanvEdge* edge, GanvEdgePath* path);
+
+/* Return true if an edge can be drawn as part of a bundle */
+gboolean
+ganv_edge_can_bundle(const GanvEdge* edge);
+
+/* Return true if two edges are drawn with the same colour, width, and dash */
+gboolean
+ganv_edge_same_stroke(const GanvEdge* a, const GanvEdge* b);
+
+/* Draw edges with the same stroke as one path, then others over them */
+void
+ganv_edge_draw_bundle(GanvEdge** edges,
+                      guint      n_edges,
+                      GanvEdge** others,
+                      guint      n_others,
+                      cairo_t*   cr);
+
+/* Destroy all children of a group for which pred returns true.  Destroying a
+   child must not destroy any of its siblings. */
+void
+ganv_group_destroy_children(GanvGroup* group, gboolean (*pred)(GanvItem*));
+
 void
 ganv_item_emit_event(GanvItem* item, GdkEvent* event, gint* finished);
 
+/* Queue a top level item to be updated before the next redraw */
+void
+ganv_canvas_queue_update(GanvCanvas* canvas, GanvItem* item);
+
 void
 ganv_canvas_request_update(GanvCanvas* canvas);
 
@@ -333,6 +479,10 @@ ganv_canvas_emit_event(GanvCanvas* canvas, GdkEvent* event);
 void
 ganv_canvas_set_need_repick(GanvCanvas* canvas);
 
+/* Notify the canvas that a top level item may have new bounds */
+void
+ganv_canvas_item_bounds_changed(GanvCanvas* canvas, GanvItem* item);
+
 void
 ganv_canvas_forget_item(GanvCanvas* canvas, GanvItem* item);
 
@@ -50,6 +50,7 @@ ganv_group_init(GanvGroup* group)
 	group->impl                = impl;
 	group->impl->item_list     = NULL;
 	group->impl->item_list_end = NULL;
+	group->impl->n_added       = 0;
 }
 
 static void
@@ -371,6 +372,8 @@ ganv_group_add(GanvItem* parent, GanvItem* item)
 	GanvGroup* group = GANV_GROUP(parent);
 	g_object_ref_sink(G_OBJECT(item));
 
+	item->impl->order = group->impl->n_added++;
+
 	if (!group->impl->item_list) {
 		group->impl->item_list     = g_list_append(group->impl->item_list, item);
 		group->impl->item_list_end = group->impl->item_list;
@@ -410,6 +413,7 @@ ganv_group_remove(GanvItem* parent, GanvItem* item)
 
 			/* Unparent the child */
 
+			ganv_item_invalidate_offsets(item);
 			item->impl->parent = NULL;
 			g_object_unref(G_OBJECT(item));
 
@@ -426,6 +430,37 @@ ganv_group_remove(GanvItem* parent, GanvItem* item)
 	}
 }
 
+void
+ganv_group_destroy_children(GanvGroup* group, gboolean (*pred)(GanvItem*))
+{
+	GList* next = NULL;
+	for (GList* l = group->impl->item_list; l; l = next) {
+		GanvItem* item = GANV_ITEM(l->data);
+
+		next = l->next;
+		if (!pred(item)) {
+			continue;
+		}
+
+		/* Unlink the child here, which is much faster than having
+		   ganv_group_remove() search the list for it on destroy */
+
+		if (l == group->impl->item_list_end) {
+			group->impl->item_list_end = l->prev;
+		}
+
+		group->impl->item_list = g_list_delete_link(group->impl->item_list, l);
+		item->impl->parent     = NULL;
+
+		gtk_object_destroy(GTK_OBJECT(item));
+		g_object_unref(G_OBJECT(item));
+	}
+
+	if (group->item.impl->canvas) {
+		ganv_canvas_invalidate_offsets(group->item.impl->canvas);
+	}
+}
+
 static void
 ganv_group_class_init(GanvGroupClass* klass)
 {
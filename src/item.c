@@ -85,8 +85,10 @@ ganv_item_init(GanvItem* item)
 
 	item->object.flags |= GANV_ITEM_VISIBLE;
 	item->impl          = impl;
-	item->impl->managed = FALSE;
-	item->impl->wrapper = NULL;
+	item->impl->managed      = FALSE;
+	item->impl->wrapper      = NULL;
+	item->impl->offset_top   = NULL;
+	item->impl->offset_stamp = 0;
 }
 
 /**
@@ -162,15 +164,18 @@ ganv_item_set_property(GObject*      object,
 		} else if (g_value_get_object(value)) {
 			item->impl->parent = GANV_ITEM(g_value_get_object(value));
 			item->impl->canvas = item->impl->parent->impl->canvas;
+			ganv_item_invalidate_offsets(item);
 			item_post_create_setup(item);
 		}
 		break;
 	case ITEM_PROP_X:
 		item->impl->x = g_value_get_double(value);
+		ganv_item_invalidate_offsets(item);
 		ganv_item_request_update(item);
 		break;
 	case ITEM_PROP_Y:
 		item->impl->y = g_value_get_double(value);
+		ganv_item_invalidate_offsets(item);
 		ganv_item_request_update(item);
 		break;
 	case ITEM_PROP_MANAGED:
@@ -231,6 +236,8 @@ ganv_item_construct(GanvItem* item, GanvItem* parent,
 	item->impl->wrapper = NULL;
 	item->impl->canvas  = item->impl->parent->impl->canvas;
 	item->impl->layer   = 0;
+	item->impl->order   = 0;
+	ganv_item_invalidate_offsets(item);
 
 	g_object_set_valist(G_OBJECT(item), first_arg_name, args);
 
@@ -361,6 +368,10 @@ ganv_item_invoke_update(GanvItem* item, int flags)
 			GANV_ITEM_GET_CLASS(item)->update(item, child_flags);
 			g_assert(!(GTK_OBJECT_FLAGS(item) & GANV_ITEM_NEED_UPDATE));
 		}
+
+		if (item->impl->canvas && item->impl->parent) {
+			ganv_canvas_item_bounds_changed(item->impl->canvas, item);
+		}
 	}
 }
 
@@ -441,6 +452,7 @@ ganv_item_move(GanvItem* item, double dx, double dy)
 
 	item->impl->x += dx;
 	item->impl->y += dy;
+	ganv_item_invalidate_offsets(item);
 
 	ganv_item_request_update(item);
 	ganv_canvas_set_need_repick(item->impl->canvas);
@@ -487,18 +499,62 @@ ganv_item_hide(GanvItem* item)
 	}
 }
 
+void
+ganv_item_invalidate_offsets(GanvItem* item)
+{
+	/* Offsets are cached relative to the top level ancestor, so only moving
+	   something below the top level invalidates them */
+	GanvItem* parent = item->impl->parent;
+	if (parent && parent->impl->parent && item->impl->canvas) {
+		ganv_canvas_invalidate_offsets(item->impl->canvas);
+	}
+}
+
 void
 ganv_item_i2w_offset(GanvItem* item, double* px, double* py)
 {
-	double x = 0.0;
-	double y = 0.0;
-	while (item) {
-		x += item->impl->x;
-		y += item->impl->y;
-		item = item->impl->parent;
+	if (!item) {
+		*px = *py = 0.0;
+		return;
 	}
-	*px = x;
-	*py = y;
+
+	GanvItemPrivate* impl   = item->impl;
+	GanvItem*        parent = impl->parent;
+	const guint      stamp  =
+		impl->canvas ? ganv_canvas_get_position_stamp(impl->canvas) : 0;
+	if (!parent || !parent->impl->parent || !stamp) {
+		// The root or a top level item, which is cheaper to calculate directly
+		double x = 0.0;
+		double y = 0.0;
+		ganv_item_i2w_offset(parent, &x, &y);
+		*px = x + impl->x;
+		*py = y + impl->y;
+		return;
+	}
+
+	if (impl->offset_stamp != stamp) {
+		// Sum positions up to, but not including, the top level ancestor
+		GanvItem* top = item;
+		double    x   = 0.0;
+		double    y   = 0.0;
+		while (top->impl->parent && top->impl->parent->impl->parent) {
+			x  += top->impl->x;
+			y  += top->impl->y;
+			top = top->impl->parent;
+		}
+
+		impl->offset_x     = x;
+		impl->offset_y     = y;
+		impl->offset_top   = top;
+		impl->offset_stamp = stamp;
+	}
+
+	// Top level items move often, so are added here rather than cached
+	double top_x = 0.0;
+	double top_y = 0.0;
+	ganv_item_i2w_offset(impl->offset_top, &top_x, &top_y);
+	*px = top_x + impl->offset_x;
+	*py = top_y + impl->offset_y;
 }
 
 /**
@@ -619,9 +675,16 @@ ganv_item_request_update(GanvItem* item)
 		return;
 	}
 
+	const gboolean queued = (item->object.flags & GANV_ITEM_NEED_UPDATE);
+
 	item->object.flags |= GANV_ITEM_NEED_UPDATE;
 
-	if (item->impl->parent != NULL &&
+	if (item->impl->parent == ganv_canvas_root(item->impl->canvas)) {
+		/* Top level item, queue it to be updated directly by the canvas */
+		if (!queued) {
+			ganv_canvas_queue_update(item->impl->canvas, item);
+		}
+	} else if (item->impl->parent != NULL &&
 	    !(item->impl->parent->object.flags & GANV_ITEM_NEED_UPDATE)) {
 		/* Recurse up the tree */
 		ganv_item_request_update(item->impl->parent);
@@ -38,12 +38,14 @@
 #include <string.h>
 
 #define FOREACH_PORT(ports, i) \
-	for (GanvPort** i = (GanvPort**)ports->pdata; \
-	     i != (GanvPort**)ports->pdata + ports->len; ++i)
+	for (GanvPort **i = (GanvPort**)(ports)->pdata, \
+	              **i##_end = i + (ports)->len; \
+	     i != i##_end; ++i)
 
 #define FOREACH_PORT_CONST(ports, i) \
-	for (const GanvPort** i = (const GanvPort**)ports->pdata; \
-	     i != (const GanvPort**)ports->pdata + ports->len; ++i)
+	for (const GanvPort **i = (const GanvPort**)(ports)->pdata, \
+	                    **i##_end = i + (ports)->len; \
+	     i != i##_end; ++i)
 
 static const double PAD              = 2.0;
 static const double EDGE_PAD         = 5.0;
@@ -69,7 +71,10 @@ ganv_module_init(GanvModule* module)
 	GANV_NODE(module)->impl->can_head = FALSE;
 	GANV_NODE(module)->impl->can_tail = FALSE;
 
-	impl->ports = g_ptr_array_new();
+	impl->ports         = g_ptr_array_new();
+	impl->n_holes       = 0;
+	impl->n_inputs      = 0;
+	impl->n_outputs     = 0;
 	impl->embed_item    = NULL;
 	impl->embed_width   = 0;
 	impl->embed_height  = 0;
@@ -78,6 +83,34 @@ ganv_module_init(GanvModule* module)
 	impl->must_reorder  = FALSE;
 }
 
+/* Remove the holes left by removed ports, so ports are contiguous */
+static void
+compact_ports(GanvModulePrivate* impl)
+{
+	guint n = 0;
+	for (guint i = 0; i < impl->ports->len; ++i) {
+		GanvPort* const port = (GanvPort*)g_ptr_array_index(impl->ports, i);
+		if (port) {
+			port->impl->module_index = n;
+			g_ptr_array_index(impl->ports, n++) = port;
+		}
+	}
+
+	g_ptr_array_set_size(impl->ports, n);
+	impl->n_holes = 0;
+}
+
+/* Return the ports array, without holes */
+static GPtrArray*
+get_ports(GanvModule* module)
+{
+	if (module->impl->n_holes) {
+		compact_ports(module->impl);
+	}
+
+	return module->impl->ports;
+}
+
 static void
 ganv_module_destroy(GtkObject* object)
 {
@@ -88,7 +121,7 @@ ganv_module_destroy(GtkObject* object)
 	GanvModulePrivate* impl   = module->impl;
 
 	if (impl->ports) {
-		FOREACH_PORT(impl->ports, p) {
+		FOREACH_PORT(get_ports(module), p) {
 			g_object_unref(GTK_OBJECT(*p));
 		}
 		g_ptr_array_free(impl->ports, TRUE);
@@ -154,10 +187,7 @@ static void
 title_size(GanvModule* module, double* w, double* h)
 {
 	if (module->box.node.impl->label) {
-		g_object_get(G_OBJECT(module->box.node.impl->label),
-		             "width", w,
-		             "height", h,
-		             NULL);
+		ganv_text_get_size(module->box.node.impl->label, w, h);
 	} else {
 		*w = *h = 0.0;
 	}
@@ -186,18 +216,8 @@ measure(GanvModule* module, Metrics* m)
 		m->input_width  = ganv_module_get_empty_port_breadth(module);
 		m->output_width = ganv_module_get_empty_port_breadth(module);
 
-		// TODO: cache this or merge with resize_right
-		unsigned n_inputs  = 0;
-		unsigned n_outputs = 0;
-		FOREACH_PORT(impl->ports, pi) {
-			if ((*pi)->impl->is_input) {
-				++n_inputs;
-			} else {
-				++n_outputs;
-			}
-		}
-
-		const unsigned hor_ports = MAX(1, MAX(n_inputs, n_outputs));
+		// Counted by measure_ports()
+		const unsigned hor_ports = MAX(1, MAX(impl->n_inputs, impl->n_outputs));
 		const double ports_width = (2 * EDGE_PAD) +
 			((m->input_width) * hor_ports) +
 			((PAD + 1.0) * (hor_ports - 1));
@@ -286,6 +306,7 @@ place_title(GanvModule* module, GanvDirection dir)
 		t->impl->x = (ganv_box_get_width(box) - title_w) / 2.0;
 		t->impl->y = ganv_module_get_empty_port_depth(module) + 1.0;
 	}
+	ganv_item_invalidate_offsets(t);
 }
 
 static void
@@ -322,7 +343,7 @@ resize_right(GanvModule* module)
 	// Move ports to appropriate locations
 	double   in_y           = header_height;
 	double   out_y          = header_height;
-	FOREACH_PORT(impl->ports, pi) {
+	FOREACH_PORT(get_ports(module), pi) {
 		GanvPort* const p     = (*pi);
 		GanvBox*  const pbox  = GANV_BOX(p);
 		GanvNode* const pnode = GANV_NODE(p);
@@ -396,7 +417,7 @@ resize_down(GanvModule* module)
 	guint  out_count = 0;
 	double in_x      = 0.0;
 	double out_x     = 0.0;
-	FOREACH_PORT(impl->ports, pi) {
+	FOREACH_PORT(get_ports(module), pi) {
 		GanvPort* const p     = (*pi);
 		GanvBox*  const pbox  = GANV_BOX(p);
 		GanvNode* const pnode = GANV_NODE(p);
@@ -432,16 +453,20 @@ measure_ports(GanvModule* module)
 {
 	GanvModulePrivate* impl = module->impl;
 
+	impl->n_inputs      = 0;
+	impl->n_outputs     = 0;
 	impl->widest_input  = 0.0;
 	impl->widest_output = 0.0;
-	FOREACH_PORT_CONST(impl->ports, pi) {
+	FOREACH_PORT_CONST(get_ports(module), pi) {
 		const GanvPort* const p = (*pi);
 		const double          w = ganv_port_get_natural_width(p);
 		if (p->impl->is_input) {
+			++impl->n_inputs;
 			if (w > impl->widest_input) {
 				impl->widest_input = w;
 			}
 		} else {
+			++impl->n_outputs;
 			if (w > impl->widest_output) {
 				impl->widest_output = w;
 			}
@@ -459,10 +484,7 @@ ganv_module_resize(GanvNode* self)
 	double label_w = 0.0;
 	double label_h = 0.0;
 	if (node->impl->label) {
-		g_object_get(node->impl->label,
-		             "width", &label_w,
-		             "height", &label_h,
-		             NULL);
+		ganv_text_get_size(node->impl->label, &label_w, &label_h);
 	}
 
 	measure_ports(module);
@@ -487,7 +509,7 @@ ganv_module_resize(GanvNode* self)
 static void
 ganv_module_redraw_text(GanvNode* self)
 {
-	FOREACH_PORT(GANV_MODULE(self)->impl->ports, p) {
+	FOREACH_PORT(get_ports(GANV_MODULE(self)), p) {
 		ganv_node_redraw_text(GANV_NODE(*p));
 	}
 
@@ -510,7 +532,11 @@ ganv_module_add_port(GanvModule* module,
 		impl->widest_output = width;
 	}
 
-	// Add to port array
+	// Add to port array, compacting first if it is mostly holes
+	if (impl->ports->len >= 2 * (impl->ports->len - impl->n_holes) + 16) {
+		compact_ports(impl);
+	}
+	port->impl->module_index = impl->ports->len;
 	g_ptr_array_add(impl->ports, port);
 
 	// Request update with resize and reorder
@@ -522,30 +548,15 @@ static void
 ganv_module_remove_port(GanvModule* module,
                         GanvPort*   port)
 {
-	gboolean removed = g_ptr_array_remove(module->impl->ports, port);
-	if (removed) {
-		const double width = ganv_box_get_width(GANV_BOX(port));
-		// Find new widest input or output, if necessary
-		if (port->impl->is_input && width >= module->impl->widest_input) {
-			module->impl->widest_input = 0;
-			FOREACH_PORT_CONST(module->impl->ports, i) {
-				const GanvPort* const p = (*i);
-				const double          w = ganv_box_get_width(GANV_BOX(p));
-				if (p->impl->is_input && w >= module->impl->widest_input) {
-					module->impl->widest_input = w;
-				}
-			}
-		} else if (!port->impl->is_input && width >= module->impl->widest_output) {
-			module->impl->widest_output = 0;
-			FOREACH_PORT_CONST(module->impl->ports, i) {
-				const GanvPort* const p = (*i);
-				const double          w = ganv_box_get_width(GANV_BOX(p));
-				if (!p->impl->is_input && w >= module->impl->widest_output) {
-					module->impl->widest_output = w;
-				}
-			}
-		}
-
+	GanvModulePrivate* impl = module->impl;
+	const guint        i    = port->impl->module_index;
+	if (i < impl->ports->len && g_ptr_array_index(impl->ports, i) == port) {
+		// Leave a hole rather than shifting every following port down
+		g_ptr_array_index(impl->ports, i) = NULL;
+		port->impl->module_index = G_MAXUINT;
+		++impl->n_holes;
+
+		// Widths and counts are measured again in the resize
 		GANV_NODE(module)->impl->must_resize = TRUE;
 	} else {
 		fprintf(stderr, "Failed to find port to remove\n");
@@ -592,10 +603,14 @@ ganv_module_update(GanvItem* item, int flags)
 		// Sort ports array
 		PortOrderCtx ctx = ganv_canvas_get_port_order(canvas);
 		if (ctx.port_cmp) {
-			g_ptr_array_sort_with_data(module->impl->ports,
+			GPtrArray* const ports = get_ports(module);
+			g_ptr_array_sort_with_data(ports,
 			                           (GCompareDataFunc)ptr_sort,
-
 			                           &ctx);
+			for (guint i = 0; i < ports->len; ++i) {
+				GanvPort* const port = (GanvPort*)g_ptr_array_index(ports, i);
+				port->impl->module_index = i;
+			}
 		}
 		module->impl->must_reorder = FALSE;
 	}
@@ -605,7 +620,7 @@ ganv_module_update(GanvItem* item, int flags)
 		ganv_item_move(GANV_ITEM(module->impl->embed_item), 0.0, 0.0);
 	}
 
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		ganv_item_invoke_update(GANV_ITEM(*p), flags);
 	}
 
@@ -635,7 +650,7 @@ ganv_module_draw(GanvItem* item,
 	}
 
 	// Draw ports
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		GANV_ITEM_GET_CLASS(GANV_ITEM(*p))->draw(
 			GANV_ITEM(*p), cr, cx, cy, cw, ch);
 	}
@@ -654,7 +669,7 @@ ganv_module_move_to(GanvNode* node,
 {
 	GanvModule* module = GANV_MODULE(node);
 	GANV_NODE_CLASS(parent_class)->move_to(node, x, y);
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		ganv_node_move(GANV_NODE(*p), 0.0, 0.0);
 	}
 	if (module->impl->embed_item) {
@@ -669,7 +684,7 @@ ganv_module_move(GanvNode* node,
 {
 	GanvModule* module = GANV_MODULE(node);
 	GANV_NODE_CLASS(parent_class)->move(node, dx, dy);
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		ganv_node_move(GANV_NODE(*p), 0.0, 0.0);
 	}
 	if (module->impl->embed_item) {
@@ -689,7 +704,7 @@ ganv_module_point(GanvItem* item, double x, double y, GanvItem** actual_item)
 		return d;
 	}
 
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		GanvItem* const port = GANV_ITEM(*p);
 
 		*actual_item = NULL;
@@ -752,14 +767,15 @@ ganv_module_new(GanvCanvas* canvas,
 guint
 ganv_module_num_ports(const GanvModule* module)
 {
-	return module->impl->ports ? module->impl->ports->len : 0;
+	const GanvModulePrivate* impl = module->impl;
+	return impl->ports ? impl->ports->len - impl->n_holes : 0;
 }
 
 GanvPort*
 ganv_module_get_port(GanvModule* module,
                      guint       index)
 {
-	return (GanvPort*)g_ptr_array_index(module->impl->ports, index);
+	return (GanvPort*)g_ptr_array_index(get_ports(module), index);
 }
 
 double
@@ -855,7 +871,7 @@ void
 ganv_module_set_direction(GanvModule*   module,
                           GanvDirection direction)
 {
-	FOREACH_PORT(module->impl->ports, p) {
+	FOREACH_PORT(get_ports(module), p) {
 		ganv_port_set_direction(*p, direction);
 	}
 	GANV_NODE(module)->impl->must_resize = TRUE;
@@ -867,10 +883,10 @@ ganv_module_for_each_port(GanvModule*  module,
                           GanvPortFunc f,
                           void*        data)
 {
-	GanvModulePrivate* impl = module->impl;
-	const int          len  = impl->ports->len;
-	GanvPort**         copy = (GanvPort**)malloc(sizeof(GanvPort*) * len);
-	memcpy(copy, impl->ports->pdata, sizeof(GanvPort*) * len);
+	GPtrArray* const ports = get_ports(module);
+	const int        len   = ports->len;
+	GanvPort**       copy  = (GanvPort**)malloc(sizeof(GanvPort*) * len);
+	memcpy(copy, ports->pdata, sizeof(GanvPort*) * len);
 
 	for (int i = 0; i < len; ++i) {
 		f(copy[i], data);
@@ -70,22 +70,25 @@ ganv_node_init(GanvNode* node)
 
 	node->impl = impl;
 
-	impl->partner      = NULL;
-	impl->label        = NULL;
-	impl->dash_length  = 0.0;
-	impl->dash_offset  = 0.0;
-	impl->border_width = 2.0;
-	impl->fill_color   = DEFAULT_FILL_COLOR;
-	impl->border_color = DEFAULT_BORDER_COLOR;
-	impl->can_tail     = FALSE;
-	impl->can_head     = FALSE;
-	impl->is_source    = FALSE;
-	impl->selected     = FALSE;
-	impl->highlighted  = FALSE;
-	impl->draggable    = FALSE;
-	impl->show_label   = TRUE;
-	impl->grabbed      = FALSE;
-	impl->must_resize  = FALSE;
+	impl->partner        = NULL;
+	impl->label          = NULL;
+	impl->dash_length    = 0.0;
+	impl->dash_offset    = 0.0;
+	impl->border_width   = 2.0;
+	impl->fill_color     = DEFAULT_FILL_COLOR;
+	impl->border_color   = DEFAULT_BORDER_COLOR;
+	impl->can_tail       = FALSE;
+	impl->can_head       = FALSE;
+	impl->is_source      = FALSE;
+	impl->selected       = FALSE;
+	impl->highlighted    = FALSE;
+	impl->draggable      = FALSE;
+	impl->show_label     = TRUE;
+	impl->grabbed        = FALSE;
+	impl->must_resize    = FALSE;
+	impl->canvas_index   = G_MAXUINT;
+	impl->selected_index = G_MAXUINT;
+	impl->stale_index    = G_MAXUINT;
 #ifdef GANV_FDGL
 	impl->force.x       = 0.0;
 	impl->force.y       = 0.0;
@@ -129,36 +132,6 @@ ganv_node_destroy(GtkObject* object)
 	item->impl->canvas = NULL;
 }
 
-/// Expands the canvas to contain a moved/resized node if necessary
-static void
-ganv_node_expand_canvas(GanvNode* node)
-{
-	GanvItem*   item   = GANV_ITEM(node);
-	GanvCanvas* canvas = ganv_item_get_canvas(item);
-
-	if (item->impl->parent == ganv_canvas_root(canvas)) {
-		const double pad = 10.0;
-
-		double x1 = 0.0;
-		double y1 = 0.0;
-		double x2 = 0.0;
-		double y2 = 0.0;
-		ganv_item_get_bounds(item, &x1, &y1, &x2, &y2);
-
-		ganv_item_i2w(item, &x1, &y1);
-		ganv_item_i2w(item, &x2, &y2);
-
-		double canvas_w = 0.0;
-		double canvas_h = 0.0;
-		ganv_canvas_get_size(canvas, &canvas_w, &canvas_h);
-		if (x2 + pad > canvas_w || y2 + pad > canvas_h) {
-			ganv_canvas_resize(canvas,
-			                   MAX(x1 + pad, canvas_w),
-			                   MAX(y2 + pad, canvas_h));
-		}
-	}
-}
-
 static void
 ganv_node_update(GanvItem* item, int flags)
 {
@@ -173,8 +146,6 @@ ganv_node_update(GanvItem* item, int flags)
 	}
 
 	GANV_ITEM_CLASS(parent_class)->update(item, flags);
-
-	ganv_node_expand_canvas(node);
 }
 
 static void
@@ -418,8 +389,15 @@ ganv_node_default_tick(GanvNode* self,
                        double    seconds)
 {
 	GanvNode* node = GANV_NODE(self);
+	GanvItem* item = GANV_ITEM(self);
 	node->impl->dash_offset = seconds * 8.0;
-	ganv_item_request_update(GANV_ITEM(self));
+
+	// Only the dashes move, so redraw without updating geometry
+	if (item->impl->canvas) {
+		ganv_canvas_request_redraw_w(item->impl->canvas,
+		                             item->impl->x1, item->impl->y1,
+		                             item->impl->x2, item->impl->y2);
+	}
 }
 
 static void
@@ -453,6 +431,7 @@ ganv_node_default_move_to(GanvNode* node,
 	GanvCanvas* canvas = ganv_item_get_canvas(item);
 	item->impl->x = x;
 	item->impl->y = y;
+	ganv_item_invalidate_offsets(item);
 	if (node->impl->can_tail) {
 		ganv_canvas_for_each_edge_from(
 			canvas, node, (GanvEdgeFunc)ganv_edge_update_location, NULL);
@@ -529,8 +508,7 @@ ganv_node_default_event(GanvItem* item,
 
 	case GDK_BUTTON_RELEASE:
 		if (dragging) {
-			gboolean selected = FALSE;
-			g_object_get(G_OBJECT(node), "selected", &selected, NULL);
+			const gboolean selected = node->impl->selected;
 			ganv_canvas_ungrab_item(GANV_ITEM(node), event->button.time);
 			node->impl->grabbed = FALSE;
 			dragging = FALSE;
@@ -560,8 +538,7 @@ ganv_node_default_event(GanvItem* item,
 
 	case GDK_MOTION_NOTIFY:
 		if ((dragging && (event->motion.state & GDK_BUTTON1_MASK))) {
-			gboolean selected = FALSE;
-			g_object_get(G_OBJECT(node), "selected", &selected, NULL);
+			const gboolean selected = node->impl->selected;
 
 			double new_x = event->motion.x;
 			double new_y = event->motion.y;
@@ -948,9 +925,7 @@ ganv_node_disconnect(GanvNode* node)
 }
 
 gboolean
-ganv_node_is_selected(GanvNode* node)
+ganv_node_is_selected(const GanvNode* node)
 {
-	gboolean selected = FALSE;
-	g_object_get(node, "selected", &selected, NULL);
-	return selected;
+	return node->impl->selected;
 }
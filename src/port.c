@@ -71,6 +71,7 @@ ganv_port_init(GanvPort* port)
 	port->impl->value_label     = NULL;
 	port->impl->is_input        = TRUE;
 	port->impl->is_controllable = FALSE;
+	port->impl->module_index    = G_MAXUINT;
 }
 
 static void
@@ -323,10 +324,10 @@ ganv_port_resize(GanvNode* self)
 	double vlabel_w = 0.0;
 	double vlabel_h = 0.0;
 	if (label && (GANV_ITEM(label)->object.flags & GANV_ITEM_VISIBLE)) {
-		g_object_get(label, "width", &label_w, "height", &label_h, NULL);
+		ganv_text_get_size(label, &label_w, &label_h);
 	}
 	if (vlabel && (GANV_ITEM(vlabel)->object.flags & GANV_ITEM_VISIBLE)) {
-		g_object_get(vlabel, "width", &vlabel_w, "height", &vlabel_h, NULL);
+		ganv_text_get_size(vlabel, &vlabel_w, &vlabel_h);
 	}
 
 	if (label || vlabel) {
@@ -700,7 +701,8 @@ ganv_port_get_natural_width(const GanvPort* port)
 		w = ganv_module_get_empty_port_breadth(ganv_port_get_module(port));
 	} else if (label && (GANV_ITEM(label)->object.flags & GANV_ITEM_VISIBLE)) {
 		double label_w = 0.0;
-		g_object_get(port->box.node.impl->label, "width", &label_w, NULL);
+		double label_h = 0.0;
+		ganv_text_get_size(label, &label_w, &label_h);
 		w = label_w + (PORT_LABEL_HPAD * 2.0);
 	} else {
 		w = ganv_module_get_empty_port_depth(ganv_port_get_module(port));
@@ -709,7 +711,8 @@ ganv_port_get_natural_width(const GanvPort* port)
 	    (GANV_ITEM(port->impl->value_label)->object.flags
 	     & GANV_ITEM_VISIBLE)) {
 		double label_w = 0.0;
-		g_object_get(port->impl->value_label, "width", &label_w, NULL);
+		double label_h = 0.0;
+		ganv_text_get_size(port->impl->value_label, &label_w, &label_h);
 		w += label_w + PORT_LABEL_HPAD;
 	}
 	return w;
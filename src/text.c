@@ -28,10 +28,8 @@
 #include <glib-object.h>
 #include <glib.h>
 #include <gtk/gtk.h>
-#include <pango/pango-font.h>
 #include <pango/pango-layout.h>
 #include <pango/pango-types.h>
-#include <pango/pangocairo.h>
 
 #include <math.h>
 #include <stdlib.h>
@@ -79,8 +77,9 @@ ganv_text_destroy(GtkObject* object)
 	g_return_if_fail(object != NULL);
 	g_return_if_fail(GANV_IS_TEXT(object));
 
-	GanvText*        text = GANV_TEXT(object);
-	GanvTextPrivate* impl = text->impl;
+	GanvText*        text   = GANV_TEXT(object);
+	GanvTextPrivate* impl   = text->impl;
+	GanvCanvas*      canvas = GANV_ITEM(text)->impl->canvas;
 
 	if (impl->text) {
 		g_free(impl->text);
@@ -88,7 +87,11 @@ ganv_text_destroy(GtkObject* object)
 	}
 
 	if (impl->layout) {
-		g_object_unref(impl->layout);
+		if (canvas) {
+			ganv_canvas_release_layout(canvas, impl->layout);
+		} else {
+			g_object_unref(impl->layout);
+		}
 		impl->layout = NULL;
 	}
 
@@ -103,33 +106,22 @@ ganv_text_layout(GanvText* text)
 	GanvTextPrivate* impl   = text->impl;
 	GanvItem*        item   = GANV_ITEM(text);
 	GanvCanvas*      canvas = ganv_item_get_canvas(item);
-	GtkWidget*       widget = GTK_WIDGET(canvas);
 	double           points = impl->font_size;
-	GtkStyle*        style  = gtk_rc_get_style(widget);
 
 	if (impl->font_size == 0.0) {
 		points = ganv_canvas_get_font_size(canvas);
 	}
 
-	if (impl->layout) {
-		g_object_unref(impl->layout);
-	}
-	impl->layout = gtk_widget_create_pango_layout(widget, impl->text);
-
-	PangoFontDescription* font = pango_font_description_copy(style->font_desc);
-	PangoContext*         ctx  = pango_layout_get_context(impl->layout);
-	cairo_font_options_t* opt  = cairo_font_options_copy(
-		pango_cairo_context_get_font_options(ctx));
-
-	pango_font_description_set_size(font, points * (double)PANGO_SCALE);
-	pango_layout_set_font_description(impl->layout, font);
-	pango_cairo_context_set_font_options(ctx, opt);
-	cairo_font_options_destroy(opt);
-	pango_font_description_free(font);
+	// Get the new layout first, so an unchanged one stays cached in between
+	PangoLayout* const old_layout = impl->layout;
+	int                width      = 0;
+	int                height     = 0;
+	impl->layout = ganv_canvas_get_layout(
+		canvas, impl->text, points, &width, &height);
 
-	int width  = 0;
-	int height = 0;
-	pango_layout_get_pixel_size(impl->layout, &width, &height);
+	if (old_layout) {
+		ganv_canvas_release_layout(canvas, old_layout);
+	}
 
 	impl->coords.width  = width;
 	impl->coords.height = height;
@@ -138,6 +130,19 @@ ganv_text_layout(GanvText* text)
 	ganv_item_request_update(GANV_ITEM(text));
 }
 
+void
+ganv_text_get_size(GanvText* text, double* width, double* height)
+{
+	GanvTextPrivate* impl = text->impl;
+
+	if (impl->needs_layout) {
+		ganv_text_layout(text);
+	}
+
+	*width  = impl->coords.width;
+	*height = impl->coords.height;
+}
+
 static void
 ganv_text_set_property(GObject*      object,
                        guint         prop_id,
@@ -165,7 +170,7 @@ ganv_text_set_property(GObject*      object,
 		impl->needs_layout = TRUE;
 		break;
 	case PROP_TEXT:
-		free(impl->text);
+		g_free(impl->text);
 		impl->text         = g_value_dup_string(value);
 		impl->needs_layout = TRUE;
 		break;
@@ -316,8 +321,7 @@ ganv_text_draw(GanvItem* item,
 	color_to_rgba(impl->color, &r, &g, &b, &a);
 
 	cairo_set_source_rgba(cr, r, g, b, a);
-	cairo_move_to(cr, wx, wy);
-	pango_cairo_show_layout(cr, impl->layout);
+	ganv_canvas_draw_layout(item->impl->canvas, cr, impl->layout, wx, wy);
 }
 
 static void